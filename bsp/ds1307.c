@@ -265,6 +265,32 @@ void ds1307_get_current_date(RTC_date_t *rtc_date)
 
 }
 
+/*********************************************************************
+ * @fn            - ds1307_set_bcd
+ *
+ * @brief         - Writes all time and date registers in one I2C transfer.
+ *
+ * @param[in]     - bcd: DS1307_NO_OF_TIME_REGS packed BCD values in register
+ *                  order (seconds, minutes, hours, day, date, month, year).
+ *
+ * @return        - None
+ *
+ * @Note          - No conversion is done; the clock halt bit is cleared and
+ *                  the hours are stored in 24 hour format.
+ */
+void ds1307_set_bcd(const uint8_t *bcd)
+{
+	uint8_t tx[DS1307_NO_OF_TIME_REGS + 1];
+
+	tx[0] = DS1307_ADDR_SEC;
+	memcpy(&tx[1], bcd, DS1307_NO_OF_TIME_REGS);
+
+	tx[1 + DS1307_ADDR_SEC] &= ~(1 << 7);
+	tx[1 + DS1307_ADDR_HRS] &= ~(1 << 6);
+
+	I2C_MasterSendData(&g_ds1307I2cHandle, tx, sizeof(tx), DS1307_I2C_ADDRESS, 0);
+}
+
 /*
  * MIT License
  *
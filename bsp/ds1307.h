@@ -39,6 +39,7 @@
 #define DS1307_ADDR_DATE		0x04
 #define DS1307_ADDR_MONTH		0x05
 #define DS1307_ADDR_YEAR		0x06
+#define DS1307_NO_OF_TIME_REGS	7		// DS1307_ADDR_SEC .. DS1307_ADDR_YEAR
 
 /*
  * Time format options
@@ -114,6 +115,12 @@ void ds1307_get_current_time(RTC_time_t *);
 void ds1307_set_current_date(RTC_date_t *);
 void ds1307_get_current_date(RTC_date_t *);
 
+/*
+ * Raw register access
+ * Set time and date at once from packed BCD, as the DS1307 stores them.
+ */
+void ds1307_set_bcd(const uint8_t *bcd);
+
 #endif // __DS1307_H__
 
 /*
@@ -65,8 +65,14 @@
 /*
  * Interrupt Control
  */
-#define IRQ_EN()  __asm__ volatile ("sei")  // Enable global interrupts
-#define IRQ_DIS() __asm__ volatile ("cli")  // Disable global interrupts
+#define IRQ_EN()  __asm__ volatile ("sei" ::: "memory")  // Enable global interrupts
+#define IRQ_DIS() __asm__ volatile ("cli" ::: "memory")  // Disable global interrupts
+
+/*
+ * CPU Status Register (bit 7 holds the global interrupt enable flag).
+ * Save it before IRQ_DIS() and write it back to restore the previous interrupt state.
+ */
+#define CPU_SREG_REG     (*(volatile uint8_t *)0x5F)
 
 /*
  * System clock frequency (16 MHz)
@@ -140,6 +146,22 @@
  */
 #define USART_BASEADDR    0XC0
 
+/*
+ * Timer/Counter1 Registers for ATmega328P
+ * Base address of Timer1 peripheral and its interrupt registers.
+ */
+#define TIM1_BASEADDR      0X80
+#define TIM1_TIMSK1_REG    (*(volatile uint8_t *)0x6F)  // Timer/Counter1 Interrupt Mask Register
+#define TIM1_TIFR1_REG     (*(volatile uint8_t *)0x36)  // Timer/Counter1 Interrupt Flag Register
+
+/*
+ * Timer/Counter2 Registers for ATmega328P
+ * Base address of Timer2 peripheral and its interrupt registers.
+ */
+#define TIM2_BASEADDR      0XB0
+#define TIM2_TIMSK2_REG    (*(volatile uint8_t *)0x70)  // Timer/Counter2 Interrupt Mask Register
+#define TIM2_TIFR2_REG     (*(volatile uint8_t *)0x37)  // Timer/Counter2 Interrupt Flag Register
+
 /******************************************************************************************
  *                        Peripheral Register Definition Structures                       *
  ******************************************************************************************/
@@ -195,6 +217,37 @@ typedef struct
 
 }USART_Regs_t;
 
+/*
+ * peripheral register definition structure for Timer/Counter1
+ * The 16-bit registers go through the shared TEMP register; the compiler
+ * accesses them low byte first on reads and high byte first on writes.
+ */
+typedef struct
+{
+    volatile uint8_t  TCCR1A;
+    volatile uint8_t  TCCR1B;
+    volatile uint8_t  TCCR1C;
+    volatile uint8_t  RESVD;
+    volatile uint16_t TCNT1;
+    volatile uint16_t ICR1;
+    volatile uint16_t OCR1A;
+    volatile uint16_t OCR1B;
+
+}TIM1_Regs_t;
+
+/*
+ * peripheral register definition structure for Timer/Counter2
+ */
+typedef struct
+{
+    volatile uint8_t TCCR2A;
+    volatile uint8_t TCCR2B;
+    volatile uint8_t TCNT2;
+    volatile uint8_t OCR2A;
+    volatile uint8_t OCR2B;
+
+}TIM2_Regs_t;
+
 /******************************************************************************************
  *                                  Peripheral Definitions                                *
  ******************************************************************************************/
@@ -237,6 +290,16 @@ typedef struct
  */
 #define USART     ((USART_Regs_t *)USART_BASEADDR)
 
+ /*
+ * Timer/Counter1 peripheral for ATmega328p
+ */
+#define TIM1      ((TIM1_Regs_t *)TIM1_BASEADDR)
+
+ /*
+ * Timer/Counter2 peripheral for ATmega328p
+ */
+#define TIM2      ((TIM2_Regs_t *)TIM2_BASEADDR)
+
 /******************************************************************************************
  *                         Bit position definitions of peripherals                        *
  ******************************************************************************************/
@@ -401,6 +464,89 @@ typedef struct
 #define USART_UCSR0C_UMSEL00  6
 #define USART_UCSR0C_UMSEL01  7
 
+/*
+ * Bit position definition for USART UCSR0C REG in Master SPI Mode (MSPIM)
+ */
+#define USART_UCSR0C_UCPHA0   1
+#define USART_UCSR0C_UDORD0   2
+
+/*
+ * Bit position definitions of Timer/Counter1 peripheral
+ */
+/*
+ * Bit position definitions for TIM1 TCCR1A REG
+ */
+#define TIM1_TCCR1A_WGM10     0
+#define TIM1_TCCR1A_WGM11     1
+#define TIM1_TCCR1A_COM1B0    4
+#define TIM1_TCCR1A_COM1B1    5
+#define TIM1_TCCR1A_COM1A0    6
+#define TIM1_TCCR1A_COM1A1    7
+
+/*
+ * Bit position definitions for TIM1 TCCR1B REG
+ */
+#define TIM1_TCCR1B_CS10      0
+#define TIM1_TCCR1B_CS11      1
+#define TIM1_TCCR1B_CS12      2
+#define TIM1_TCCR1B_WGM12     3
+#define TIM1_TCCR1B_WGM13     4
+#define TIM1_TCCR1B_ICES1     6
+#define TIM1_TCCR1B_ICNC1     7
+
+/*
+ * Bit position definitions for TIM1_TIMSK1_REG
+ */
+#define TIM1_TIMSK1_TOIE1     0
+#define TIM1_TIMSK1_OCIE1A    1
+#define TIM1_TIMSK1_OCIE1B    2
+#define TIM1_TIMSK1_ICIE1     5
+
+/*
+ * Bit position definitions for TIM1_TIFR1_REG
+ */
+#define TIM1_TIFR1_TOV1       0
+#define TIM1_TIFR1_OCF1A      1
+#define TIM1_TIFR1_OCF1B      2
+#define TIM1_TIFR1_ICF1       5
+
+/*
+ * Bit position definitions of Timer/Counter2 peripheral
+ */
+/*
+ * Bit position definitions for TIM2 TCCR2A REG
+ */
+#define TIM2_TCCR2A_WGM20     0
+#define TIM2_TCCR2A_WGM21     1
+#define TIM2_TCCR2A_COM2B0    4
+#define TIM2_TCCR2A_COM2B1    5
+#define TIM2_TCCR2A_COM2A0    6
+#define TIM2_TCCR2A_COM2A1    7
+
+/*
+ * Bit position definitions for TIM2 TCCR2B REG
+ */
+#define TIM2_TCCR2B_CS20      0
+#define TIM2_TCCR2B_CS21      1
+#define TIM2_TCCR2B_CS22      2
+#define TIM2_TCCR2B_WGM22     3
+#define TIM2_TCCR2B_FOC2B     6
+#define TIM2_TCCR2B_FOC2A     7
+
+/*
+ * Bit position definitions for TIM2_TIMSK2_REG
+ */
+#define TIM2_TIMSK2_TOIE2     0
+#define TIM2_TIMSK2_OCIE2A    1
+#define TIM2_TIMSK2_OCIE2B    2
+
+/*
+ * Bit position definitions for TIM2_TIFR2_REG
+ */
+#define TIM2_TIFR2_TOV2       0
+#define TIM2_TIFR2_OCF2A      1
+#define TIM2_TIFR2_OCF2B      2
+
 /*
  * Generic Macros Definition
  */
@@ -33,18 +33,115 @@ typedef struct
 }SPI_Config_t;
 
 /*
- * Handle structure for a SPI peripheral
+ * Number of pending transactions held by SPI_XferEnqueue().
+ * Must be a power of two no larger than 128; override it from the build flags if needed.
+ */
+#ifndef SPI_XFER_QUEUE_SIZE
+#define SPI_XFER_QUEUE_SIZE     4
+#endif
+
+#if (SPI_XFER_QUEUE_SIZE < 2) || (SPI_XFER_QUEUE_SIZE > 128) || (SPI_XFER_QUEUE_SIZE & (SPI_XFER_QUEUE_SIZE - 1))
+#error "SPI_XFER_QUEUE_SIZE must be a power of two between 2 and 128"
+#endif
+
+#define SPI_XFER_QUEUE_MASK     (SPI_XFER_QUEUE_SIZE - 1)
+
+/*
+ * SPCR/SPSR values of a configuration, built at compile time with SPI_CONFIG()
+ * or at run time with SPI_ConfigToRegs()
+ */
+typedef struct
+{
+    uint8_t SPCR;    /* !< SPCR value, SPE set and SPIE clear > */
+    uint8_t SPSR;    /* !< SPSR value (SPI2X) > */
+}SPI_RegConfig_t;
+
+/*
+ * Size of the slave mode Rx and Tx rings (see SPI_SlaveStart).
+ * Must be a power of two no larger than 128; override it from the build flags if needed.
+ */
+#ifndef SPI_SLAVE_RING_SIZE
+#define SPI_SLAVE_RING_SIZE     32
+#endif
+
+#if (SPI_SLAVE_RING_SIZE < 2) || (SPI_SLAVE_RING_SIZE > 128) || (SPI_SLAVE_RING_SIZE & (SPI_SLAVE_RING_SIZE - 1))
+#error "SPI_SLAVE_RING_SIZE must be a power of two between 2 and 128"
+#endif
+
+#define SPI_SLAVE_RING_MASK     (SPI_SLAVE_RING_SIZE - 1)
+
+/*
+ * Largest number of argument bytes of a slave command
+ */
+#ifndef SPI_SLAVE_ARGS_MAX
+#define SPI_SLAVE_ARGS_MAX      4
+#endif
+
+/*
+ * Slave device on the bus, filled once by SPI_DeviceInit
+ */
+typedef struct
+{
+    SPI_RegConfig_t   Regs;      /* !< SPCR/SPSR of the device clock mode, SPE set > */
+    volatile uint8_t *pCsPort;   /* !< PORT register of the chip select pin > */
+    uint8_t           CsMask;    /* !< Chip select bit in pCsPort, active low > */
+}SPI_Device_t;
+
+/*
+ * Queued transaction (see SPI_XferEnqueue)
+ */
+struct SPI_s;
+
+typedef struct SPI_Xfer_s
+{
+    const SPI_Device_t *pDevice;     /* !< Device to select for this transaction > */
+    const uint8_t      *pTxBuffer;   /* !< Data to send, NULL clocks out FillByte > */
+    uint8_t            *pRxBuffer;   /* !< Received data, NULL discards it > */
+    uint16_t            Len;         /* !< Number of bytes to exchange > */
+    void (*pDone)(struct SPI_s *pSPIInst, struct SPI_Xfer_s *pXfer); /* !< Called from the SPI ISR after CS was released, or NULL > */
+}SPI_Xfer_t;
+
+/*
+ * Slave command table entry (see SPI_SlaveStart)
  */
 typedef struct
+{
+    uint8_t Code;      /* !< Command byte sent by the master > */
+    uint8_t ArgLen;    /* !< Argument bytes following the ack, up to SPI_SLAVE_ARGS_MAX > */
+    uint8_t (*pHandler)(struct SPI_s *pSPIInst, const uint8_t *pArgs); /* !< Runs in the SPI ISR, returns the data bytes that follow > */
+}SPI_SlaveCmd_t;
+
+/*
+ * Handle structure for a SPI peripheral
+ */
+typedef struct SPI_s
 {
     SPI_Regs_t    *pReg;
     SPI_Config_t  Config;
-   	uint8_t 	  *pTxBuffer;   /* !< To store the app. Tx buffer address > */
+   	const uint8_t *pTxBuffer;   /* !< To store the app. Tx buffer address > */
 	uint8_t 	  *pRxBuffer;	/* !< To store the app. Rx buffer address > */
-	uint32_t 	  TxLen;		/* !< To store Tx len > */
-	uint32_t 	  RxLen;		/* !< To store Tx len > */
+	uint32_t 	  TxLen;		/* !< Bytes left in the interrupt transfer > */
+	uint8_t 	  JobFill;		/* !< Fill byte of the running interrupt transfer, loaded by spi_it_start > */
 	uint8_t 	  TxState;	    /* !< To store Tx state > */
 	uint8_t 	  RxState;	    /* !< To store Rx state > */
+	uint8_t 	  FillByte;     /* !< Default fill byte when there is no Tx buffer (SPI_DUMMY_BYTE after SPI_Init) > */
+	SPI_Xfer_t * volatile XferQueue[SPI_XFER_QUEUE_SIZE]; /* !< Pending transactions, oldest at XferTail > */
+	volatile uint8_t XferHead;  /* !< Transaction queue write index > */
+	volatile uint8_t XferTail;  /* !< Transaction queue read index > */
+	volatile uint8_t XferActive; /* !< Set while the transaction at XferTail is on the bus > */
+	const SPI_SlaveCmd_t *pSlaveCmds; /* !< Slave command table, NULL for a plain byte stream > */
+	uint8_t 	  SlaveCmdCount; /* !< Entries in pSlaveCmds > */
+	const SPI_SlaveCmd_t *pSlaveCmd;  /* !< Command in progress > */
+	uint8_t 	  SlaveState;   /* !< Slave protocol phase (SPI_SLAVE_xxx) > */
+	uint8_t 	  SlaveCount;   /* !< Bytes left in the current phase > */
+	uint8_t 	  SlaveReply;   /* !< Set when the byte on the bus came from the Tx ring > */
+	uint8_t 	  SlaveArgs[SPI_SLAVE_ARGS_MAX]; /* !< Arguments of the command in progress > */
+	volatile uint8_t SlaveRx[SPI_SLAVE_RING_SIZE]; /* !< Slave Rx ring storage, filled by the SPI ISR > */
+	volatile uint8_t SlaveRxHead; /* !< Slave Rx ring write index > */
+	volatile uint8_t SlaveRxTail; /* !< Slave Rx ring read index > */
+	volatile uint8_t SlaveTx[SPI_SLAVE_RING_SIZE]; /* !< Slave Tx ring storage, drained by the SPI ISR > */
+	volatile uint8_t SlaveTxHead; /* !< Slave Tx ring write index > */
+	volatile uint8_t SlaveTxTail; /* !< Slave Tx ring read index > */
 }SPI_t;
 
 /*
@@ -145,17 +242,73 @@ typedef struct
 #define SPI_READY 					0
 #define SPI_BUSY_IN_RX 				1
 #define SPI_BUSY_IN_TX 				2
+#define SPI_BUSY_IN_TXRX 			3
+#define SPI_BUSY_IN_SLAVE 			4
+
+/*
+ * Slave protocol phases
+ */
+#define SPI_SLAVE_IDLE              0   /* Waiting for a command byte */
+#define SPI_SLAVE_ACK               1   /* Ack or nack is on the bus */
+#define SPI_SLAVE_ARGS              2   /* Collecting the arguments */
+#define SPI_SLAVE_DATA              3   /* Storing command data in the Rx ring */
+
+/*
+ * Slave answers to a command byte
+ */
+#define SPI_SLAVE_ACK_BYTE          0xF5
+#define SPI_SLAVE_NACK_BYTE         0xA5
 
 /*
  * Possible SPI Application events
  */
 #define SPI_EVENT_TX_CMPLT   1
 #define SPI_EVENT_RX_CMPLT   2
+#define SPI_EVENT_TXRX_CMPLT 3
+
+/*
+ * Default byte clocked out when a transfer has no transmit buffer (see FillByte)
+ */
+#define SPI_DUMMY_BYTE       0xFF
 
 /*
  * Generic Macros Definition
  */
  #define SPI_SPI2X_DIS_MASK        0X03
+
+/*
+ * SPI clock modes (CPOL, CPHA) as SPCR bits, for SPI_CONFIG()
+ */
+#define SPI_CLK_MODE0   ((SPI_CPOL_LOW  << SPI_SPCR_CPOL) | (SPI_CPHA_LEADING  << SPI_SPCR_CPHA))
+#define SPI_CLK_MODE1   ((SPI_CPOL_LOW  << SPI_SPCR_CPOL) | (SPI_CPHA_TRAILING << SPI_SPCR_CPHA))
+#define SPI_CLK_MODE2   ((SPI_CPOL_HIGH << SPI_SPCR_CPOL) | (SPI_CPHA_LEADING  << SPI_SPCR_CPHA))
+#define SPI_CLK_MODE3   ((SPI_CPOL_HIGH << SPI_SPCR_CPOL) | (SPI_CPHA_TRAILING << SPI_SPCR_CPHA))
+
+/*
+ * Register values of a configuration folded at compile time, e.g.
+ *   static const SPI_RegConfig_t flash = SPI_CONFIG(MASTER, MSB, MODE0, DIV2);
+ * mode: MASTER/SLAVE, order: MSB/LSB, clock: MODE0..MODE3, rate: any SPI_SCLK_FOSC_xxx suffix.
+ */
+#define SPI_CONFIG_SPCR(mode, order, clk, rate)                     \
+    ((1 << SPI_SPCR_SPE) | (SPI_MODE_##mode << SPI_SPCR_MSTR) |     \
+     (SPI_ORDER_##order << SPI_SPCR_DORD) | SPI_CLK_##clk |         \
+     ((SPI_SCLK_FOSC_##rate & SPI_SPI2X_DIS_MASK) << SPI_SPCR_SPR0))
+
+#define SPI_CONFIG_SPSR(rate)                                       \
+    ((SPI_SCLK_FOSC_##rate > SPI_SCLK_FOSC_DIV128) << SPI_SPSR_SPI2X)
+
+#define SPI_CONFIG(mode, order, clk, rate)                          \
+    { .SPCR = SPI_CONFIG_SPCR(mode, order, clk, rate), .SPSR = SPI_CONFIG_SPSR(rate) }
+
+/*
+ * Loads a SPI_RegConfig_t: two register stores, no computation. SPIE is
+ * cleared, so use it between transfers.
+ */
+#define SPI_ApplyConfig(pSPIInst, RegConfig)            \
+    do {                                                \
+        (pSPIInst)->pReg->SPSR = (RegConfig).SPSR;      \
+        (pSPIInst)->pReg->SPCR = (RegConfig).SPCR;      \
+    } while (0)
  
 /******************************************************************************************
  *                            APIs supported by this driver                               *
@@ -180,13 +333,47 @@ void SPI_ReceiveData(SPI_t   *pSPIInst, uint8_t *pRxBuffer, uint32_t Len);
 uint8_t SPI_SendDataIT(SPI_t   *pSPIInst,uint8_t *pTxBuffer, uint32_t Len);
 uint8_t SPI_ReceiveDataIT(SPI_t   *pSPIInst, uint8_t *pRxBuffer, uint32_t Len);
 
+ /*
+ * Full-duplex transfers (one byte out and one byte in per SPDR exchange)
+ */
+void    SPI_TransferData(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len);
+uint8_t SPI_TransferDataIT(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len);
+
+ /*
+ * Pipelined block transfers for fast clocks (F_CPU/2 .. F_CPU/8)
+ */
+void SPI_SendBlockFast(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint16_t Len);
+
+ /*
+ * Master block reads, the driver clocks the bus with a fill byte
+ */
+void    SPI_ReadBlock(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill);
+uint8_t SPI_ReadBlockIT(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill);
+void    SPI_ReadBlockFast(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill);
+
+ /*
+ * Transaction queue (master mode, devices switched by the driver)
+ */
+void    SPI_ConfigToRegs(const SPI_Config_t *pConfig, SPI_RegConfig_t *pRegs);
+void    SPI_DeviceInit(SPI_Device_t *pDevice, const SPI_RegConfig_t *pRegs, GPIO_t CsPin);
+uint8_t SPI_XferEnqueue(SPI_t *pSPIInst, SPI_Xfer_t *pXfer);
+uint8_t SPI_XferQueueFree(SPI_t *pSPIInst);
+
+/*
+ * Slave mode engine (ring buffers and command dispatch)
+ */
+void     SPI_SlaveStart(SPI_t *pSPIInst, const SPI_SlaveCmd_t *pCmds, uint8_t CmdCount);
+void     SPI_SlaveStop(SPI_t *pSPIInst);
+uint16_t SPI_SlaveWrite(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint16_t Len);
+uint16_t SPI_SlaveAvailable(SPI_t *pSPIInst);
+uint16_t SPI_SlaveRead(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len);
+
 /*
  * IRQ Configuration and ISR handling
  */
 void SPI_IRQInterruptConfig(SPI_t *pSPIInst, uint8_t EnorDi);
 void SPI_IRQHandling(SPI_t *pSPIInst);
-static void  spi_txe_interrupt_handle(SPI_t *pSPIInst);
-static void  spi_rxne_interrupt_handle(SPI_t *pSPIInst);
+void SPI_SlaveSsIRQHandling(SPI_t *pSPIInst);
 
 /*
  * Other Peripheral Control APIs and Macro control definition
@@ -194,6 +381,11 @@ static void  spi_rxne_interrupt_handle(SPI_t *pSPIInst);
 void SPI_Control(SPI_t *pSPIInst, uint8_t state);
 #define SPI_SlaveControl(gpio, state) GPIO_WritePin((gpio), (state))
 
+/*
+ * Application Callbacks
+ */
+void SPI_ApplicationEventCallback(SPI_t *pSPIInst, uint8_t AppEv);
+
 #endif // __ATMEGA328P_SPI_H__
 
 /*
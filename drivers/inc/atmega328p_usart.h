@@ -16,10 +16,71 @@
 #define __ATMEGA328P_USART_H__
 
 #include "atmega328p.h"
+#include "atmega328p_gpio.h"
 
 /******************************************************************************************
  *                                  Driver's Specific Details                                  *
  ******************************************************************************************/
+/*
+ * Size of the interrupt-drained transmit ring used by USART_Write().
+ * Must be a power of two no larger than 128; override it from the build flags if needed.
+ */
+#ifndef USART_TX_RING_SIZE
+#define USART_TX_RING_SIZE      64
+#endif
+
+#if (USART_TX_RING_SIZE < 2) || (USART_TX_RING_SIZE > 128) || (USART_TX_RING_SIZE & (USART_TX_RING_SIZE - 1))
+#error "USART_TX_RING_SIZE must be a power of two between 2 and 128"
+#endif
+
+#define USART_TX_RING_MASK      (USART_TX_RING_SIZE - 1)
+
+/*
+ * Size of the interrupt-fed receive ring used by USART_Read().
+ * Must be a power of two no larger than 128; override it from the build flags if needed.
+ */
+#ifndef USART_RX_RING_SIZE
+#define USART_RX_RING_SIZE      64
+#endif
+
+#if (USART_RX_RING_SIZE < 2) || (USART_RX_RING_SIZE > 128) || (USART_RX_RING_SIZE & (USART_RX_RING_SIZE - 1))
+#error "USART_RX_RING_SIZE must be a power of two between 2 and 128"
+#endif
+
+#define USART_RX_RING_MASK      (USART_RX_RING_SIZE - 1)
+
+/*
+ * Number of pending transmissions held by USART_TxEnqueue().
+ * Must be a power of two no larger than 128; override it from the build flags if needed.
+ */
+#ifndef USART_TX_QUEUE_SIZE
+#define USART_TX_QUEUE_SIZE     4
+#endif
+
+#if (USART_TX_QUEUE_SIZE < 2) || (USART_TX_QUEUE_SIZE > 128) || (USART_TX_QUEUE_SIZE & (USART_TX_QUEUE_SIZE - 1))
+#error "USART_TX_QUEUE_SIZE must be a power of two between 2 and 128"
+#endif
+
+#define USART_TX_QUEUE_MASK     (USART_TX_QUEUE_SIZE - 1)
+
+/*
+ * RTS watermarks of the receive ring (see USART_FlowControl).
+ * RTS is released when the ring holds USART_RTS_HIGH_WATER bytes and asserted
+ * again once USART_Read drains it to USART_RTS_LOW_WATER. The room above the high
+ * watermark absorbs the bytes the peer still sends after RTS goes high.
+ */
+#ifndef USART_RTS_HIGH_WATER
+#define USART_RTS_HIGH_WATER    (USART_RX_RING_SIZE - (USART_RX_RING_SIZE / 8))
+#endif
+
+#ifndef USART_RTS_LOW_WATER
+#define USART_RTS_LOW_WATER     (USART_RX_RING_SIZE / 4)
+#endif
+
+#if (USART_RTS_HIGH_WATER > USART_RX_RING_SIZE) || (USART_RTS_LOW_WATER >= USART_RTS_HIGH_WATER)
+#error "USART_RTS_LOW_WATER < USART_RTS_HIGH_WATER <= USART_RX_RING_SIZE is required"
+#endif
+
 /*
  * Configuration structure for USART peripheral
  */
@@ -30,23 +91,93 @@ typedef struct
     uint8_t  USART_WordLength;
     uint8_t  USART_ParityControl;
     uint16_t USART_Baud;
+    uint8_t  USART_MPCM;
+    uint8_t  USART_OwnAddress;
+    uint8_t  USART_SpiMode;
+    uint8_t  USART_DataOrder;
+    uint8_t  USART_IdleTime;
+    uint8_t  USART_FlowControl;
+    GPIO_t   USART_CtsPin;
+    GPIO_t   USART_RtsPin;
 }USART_Config_t;
 
 /*
- * Handle structure for a USART peripheral
+ * Receive error counters (see USART_GetStats). All counters saturate at 0xFFFF.
  */
 typedef struct
+{
+    uint16_t FrameErrors;   /* !< Frames with an invalid stop bit (FE0) > */
+    uint16_t OverrunErrors; /* !< Frames lost because the receive buffer was full (DOR0) > */
+    uint16_t ParityErrors;  /* !< Frames with a parity mismatch (UPE0) > */
+    uint16_t RxDropped;     /* !< Bytes dropped because the receive ring was full > */
+}USART_Stats_t;
+
+/*
+ * Segment of a scatter-gather transmission (see USART_SendVectorIT)
+ */
+typedef struct
+{
+    const uint8_t *pData;   /* !< Start of the segment > */
+    uint16_t       Len;     /* !< Number of bytes in the segment > */
+}USART_Segment_t;
+
+/*
+ * Pending transmission (see USART_TxEnqueue)
+ */
+struct USART_s;
+
+typedef struct USART_TxDesc_s
+{
+    const uint8_t *pData;   /* !< Data to send > */
+    uint16_t       Len;     /* !< Number of bytes > */
+    void (*pDone)(struct USART_s *pUSARTInst, struct USART_TxDesc_s *pDesc); /* !< Called from the UDRE ISR once the last byte was loaded, or NULL > */
+}USART_TxDesc_t;
+
+/*
+ * Handle structure for a USART peripheral
+ */
+typedef struct USART_s
 {
     USART_Regs_t    *pReg;
     USART_Config_t   Config;
-    uint8_t *pTxBuffer;
+    const uint8_t *pTxBuffer;
 	uint8_t *pRxBuffer;
 	uint32_t TxLen;
 	uint32_t RxLen;
 	uint8_t TxBusyState;
 	uint8_t RxBusyState;
+	uint8_t TxWord9;                             /* !< Format of pTxBuffer, @USART_Word9 > */
+	uint8_t RxWord9;                             /* !< Format of pRxBuffer, @USART_Word9 > */
+	uint8_t TxBits9;                             /* !< Ninth bits left in the current packed group > */
+	uint8_t TxPos9;                              /* !< Word index in the current packed group > */
+	uint8_t RxPos9;                              /* !< Word index in the current packed group > */
+	uint8_t *pRxBits9;                           /* !< Ninth-bit byte of the current packed group > */
+	const USART_Segment_t *pTxSeg;               /* !< Next segment of a vectored transmission > */
+	uint8_t TxSegCnt;                            /* !< Segments left after the current one > */
+	void (*pRxHandler)(struct USART_s *pUSARTInst, uint8_t Data); /* !< Per-byte handler in stream reception > */
+	void *pRxContext;                            /* !< Owner of pRxHandler (e.g. the packet channel), for the handler's use > */
+	volatile uint8_t TxRing[USART_TX_RING_SIZE]; /* !< Tx ring storage, filled by USART_Write > */
+	volatile uint8_t TxHead;                     /* !< Tx ring write index, owned by the producer > */
+	volatile uint8_t TxTail;                     /* !< Tx ring read index, owned by the UDRE ISR > */
+	volatile uint8_t TxRingActive;               /* !< Set when a byte was sent (blocking, ring or queue) since the last flush > */
+	USART_TxDesc_t * volatile TxQueue[USART_TX_QUEUE_SIZE]; /* !< Pending transmissions, oldest at TxQTail > */
+	volatile uint8_t TxQHead;                    /* !< Tx queue write index > */
+	volatile uint8_t TxQTail;                    /* !< Tx queue read index, owned by the UDRE ISR > */
+	const uint8_t *pTxQData;                     /* !< Next byte of the descriptor being sent > */
+	uint16_t TxQLen;                             /* !< Bytes left in the descriptor being sent > */
+	uint8_t TxQLoaded;                           /* !< Set once the descriptor at TxQTail was loaded > */
+	volatile uint8_t RxRing[USART_RX_RING_SIZE]; /* !< Rx ring storage, filled by the RXC ISR > */
+	volatile uint8_t RxHead;                     /* !< Rx ring write index, owned by the RXC ISR > */
+	volatile uint8_t RxTail;                     /* !< Rx ring read index, owned by the reader > */
+	volatile uint8_t CtsLevel;                   /* !< Last CTS level seen by USART_CtsIRQHandling > */
+	volatile USART_Stats_t Stats;                /* !< Receive error counters, updated by the RXC ISR > */
 }USART_t;
 
+/*
+ * Per-byte receive handler (see USART_RxStreamControl), called from the RX ISR
+ */
+typedef void (*USART_RxHandler_t)(USART_t *pUSARTInst, uint8_t Data);
+
 /*
  *@USART_Mode
  *Possible options for USART_Mode
@@ -54,25 +185,76 @@ typedef struct
 #define USART_MODE_ONLY_TX 	0
 #define USART_MODE_ONLY_RX 	1
 #define USART_MODE_TXRX  	2
+#define USART_MODE_MSPIM  	3   // Master SPI mode, XCK0 (PD4) is the clock
 
 /*
  *@USART_Baud
- *Possible options for USART_Baud
- */			
-#define USART_STD_BAUD_2400     0x01A0  // UBRRn: 416 (2400 bps)
-#define USART_STD_BAUD_4800     0x00CF  // UBRRn: 207 (4800 bps)
-#define USART_STD_BAUD_9600     0x0067  // UBRRn: 103 (9600 bps)
-#define USART_STD_BAUD_14400    0x0044  // UBRRn: 68  (14400 bps)
-#define USART_STD_BAUD_19200    0x0033  // UBRRn: 51  (19200 bps)
-#define USART_STD_BAUD_28800    0x0022  // UBRRn: 34  (28800 bps)
-#define USART_STD_BAUD_38400    0x0019  // UBRRn: 25  (38400 bps)
-#define USART_STD_BAUD_57600    0x0010  // UBRRn: 16  (57600 bps)
-#define USART_STD_BAUD_76800    0x000C  // UBRRn: 12  (76800 bps)
-#define USART_STD_BAUD_115200   0x0008  // UBRRn: 8   (115200 bps)
-#define USART_STD_BAUD_230400   0x0003  // UBRRn: 3   (230400 bps)
-#define USART_STD_BAUD_250000   0x0003  // UBRRn: 3   (250000 bps)
-#define USART_STD_BAUD_500000   0x0001  // UBRRn: 1   (500000 bps)
-#define USART_STD_BAUD_1M       0x0000  // UBRRn: 0   (1M bps)
+ *USART_Baud holds the UBRR0 value (bits 0-11) plus USART_BAUD_U2X when double speed is used.
+ *Build it with USART_BAUD(bps): the divider is computed at compile time from F_CPU in
+ *normal and double speed mode, the mode with the lowest error is selected, and the
+ *build fails if the error exceeds USART_BAUD_MAX_ERR_PERMILLE.
+ */
+#define USART_BAUD_U2X          0x8000  // Flag: USART_Init sets U2X0 (double speed)
+#define USART_BAUD_UBRR_MASK    0x0FFF  // UBRR0 is 12 bits wide
+
+#ifndef USART_BAUD_MAX_ERR_PERMILLE
+#define USART_BAUD_MAX_ERR_PERMILLE  25 // Maximum baud error accepted at build time (2.5%)
+#endif
+
+// Clock divider (UBRR + 1) rounded to nearest, never below 1
+#define USART_BAUD_DIV(bps, spb)    (((F_CPU + ((spb) / 2UL) * (bps)) / ((spb) * (bps))) ? \
+                                     ((F_CPU + ((spb) / 2UL) * (bps)) / ((spb) * (bps))) : 1UL)
+
+// Clock mismatch in CPU cycles per second for a given number of samples per bit (16 normal, 8 double speed)
+#define USART_BAUD_DIFF(bps, spb)   ((F_CPU > (spb) * (bps) * USART_BAUD_DIV(bps, spb)) ?               \
+                                     (F_CPU - (spb) * (bps) * USART_BAUD_DIV(bps, spb)) :               \
+                                     ((spb) * (bps) * USART_BAUD_DIV(bps, spb) - F_CPU))
+
+// Baud error in permille
+#define USART_BAUD_ERR(bps, spb)    (USART_BAUD_DIFF(bps, spb) / (F_CPU / 1000UL))
+
+// Normal mode is kept on ties because it tolerates more receiver error
+#define USART_BAUD_USE_U2X(bps)     ((USART_BAUD_DIFF(bps, 8UL) < USART_BAUD_DIFF(bps, 16UL)) && \
+                                     (USART_BAUD_DIV(bps, 8UL) <= (USART_BAUD_UBRR_MASK + 1UL)))
+
+#define USART_BAUD_UBRR(bps)        (USART_BAUD_USE_U2X(bps) ?                                  \
+                                     ((USART_BAUD_DIV(bps, 8UL) - 1UL) | USART_BAUD_U2X) :      \
+                                     (USART_BAUD_DIV(bps, 16UL) - 1UL))
+
+#define USART_BAUD_BEST_ERR(bps)    (USART_BAUD_USE_U2X(bps) ? USART_BAUD_ERR(bps, 8UL) : USART_BAUD_ERR(bps, 16UL))
+
+// Evaluates to 0, or breaks the build (negative array size) if the baud rate is out of tolerance
+#define USART_BAUD_CHECK(bps)       (0 * sizeof(char[((USART_BAUD_BEST_ERR(bps) <= USART_BAUD_MAX_ERR_PERMILLE) && \
+                                                     (USART_BAUD_DIV(bps, 16UL) <= (USART_BAUD_UBRR_MASK + 1UL))) ? 1 : -1]))
+
+#define USART_BAUD(bps)             ((uint16_t)(USART_BAUD_UBRR(bps) + USART_BAUD_CHECK(bps)))
+
+/*
+ * Automatic baud-rate detection (see USART_AutoBaud)
+ */
+#define USART_AUTOBAUD_SYNC     0x55    // Sync character the peer sends, 8N1
+#define USART_AUTOBAUD_OK       0
+#define USART_AUTOBAUD_TIMEOUT  1
+#define USART_AUTOBAUD_INVALID  2       // Not a sync character, or no divider within tolerance
+
+/*
+ * Standard baud rates (values shown for F_CPU = 16 MHz).
+ * 230400 is not reachable within tolerance at 16 MHz and fails to build if used.
+ */
+#define USART_STD_BAUD_2400     USART_BAUD(2400UL)     // UBRRn: 832,  U2X0=1 (0.0% error)
+#define USART_STD_BAUD_4800     USART_BAUD(4800UL)     // UBRRn: 416,  U2X0=1 (0.1% error)
+#define USART_STD_BAUD_9600     USART_BAUD(9600UL)     // UBRRn: 103         (0.2% error)
+#define USART_STD_BAUD_14400    USART_BAUD(14400UL)    // UBRRn: 138,  U2X0=1 (0.1% error)
+#define USART_STD_BAUD_19200    USART_BAUD(19200UL)    // UBRRn: 51          (0.2% error)
+#define USART_STD_BAUD_28800    USART_BAUD(28800UL)    // UBRRn: 68,   U2X0=1 (0.6% error)
+#define USART_STD_BAUD_38400    USART_BAUD(38400UL)    // UBRRn: 25          (0.2% error)
+#define USART_STD_BAUD_57600    USART_BAUD(57600UL)    // UBRRn: 34,   U2X0=1 (0.8% error)
+#define USART_STD_BAUD_76800    USART_BAUD(76800UL)    // UBRRn: 12          (0.2% error)
+#define USART_STD_BAUD_115200   USART_BAUD(115200UL)   // UBRRn: 16,   U2X0=1 (2.1% error)
+#define USART_STD_BAUD_230400   USART_BAUD(230400UL)   // UBRRn: 8,    U2X0=1 (3.7% error)
+#define USART_STD_BAUD_250000   USART_BAUD(250000UL)   // UBRRn: 3           (0.0% error)
+#define USART_STD_BAUD_500000   USART_BAUD(500000UL)   // UBRRn: 1           (0.0% error)
+#define USART_STD_BAUD_1M       USART_BAUD(1000000UL)  // UBRRn: 0           (0.0% error)
 
 /*
  *@USART_ParityControl
@@ -92,6 +274,82 @@ typedef struct
 #define USART_WORDLEN_8BITS     3
 #define USART_WORDLEN_9BITS     4
 
+/*
+ *@USART_SpiMode
+ *Clock polarity/phase in Master SPI mode (same numbering as SPI modes 0-3)
+ */
+#define USART_SPI_MODE0         0   // CPOL = 0, CPHA = 0
+#define USART_SPI_MODE1         1   // CPOL = 0, CPHA = 1
+#define USART_SPI_MODE2         2   // CPOL = 1, CPHA = 0
+#define USART_SPI_MODE3         3   // CPOL = 1, CPHA = 1
+
+/*
+ *@USART_DataOrder
+ *Bit order in Master SPI mode
+ */
+#define USART_ORDER_MSB         0
+#define USART_ORDER_LSB         1
+
+/*
+ * Master SPI mode clock: USART_Baud = USART_MSPIM_BAUD(fsck), fsck = F_CPU / (2 * (UBRR0 + 1))
+ */
+#define USART_MSPIM_BAUD(fsck)  ((uint16_t)(F_CPU / (2UL * (fsck)) - 1UL))
+
+/*
+ * Master SPI mode clock pin (XCK0 = PD4)
+ */
+#define USART_XCK {                \
+    .GPIOX = GPIOD,                \
+    .GPIO_Pin = {                  \
+        .Number = PIN4,            \
+        .Mode = MODE_OUT,          \
+        .PullUp = PULLUP_DISABLED, \
+        .AltFun = MODE_ALTFN       \
+        }                          \
+    }
+
+/*
+ *@USART_MPCM
+ *Multi-processor communication mode: ENABLE or DISABLE.
+ *When enabled the frame is forced to 9 data bits and only address frames
+ *(9th bit set) raise RXC until USART_OwnAddress is matched.
+ */
+
+/*
+ *@USART_IdleTime
+ *Silent gap that raises USART_EVENT_IDLE, in half character times (0 = disabled).
+ *Timer2 is restarted by every received frame and owned by the driver while enabled;
+ *the application routes ISR(ISR_TIMER2_COMPA) to USART_IdleIRQHandling().
+ *Gaps longer than 1024 * 256 CPU cycles (16.4 ms at 16 MHz) are clamped to that value.
+ */
+#define USART_IDLE_CHARS(n)     ((uint8_t)((n) * 2))   // e.g. USART_IDLE_CHARS(3.5) for Modbus RTU
+
+/*
+ *@USART_FlowControl
+ *Hardware flow control on GPIO pins, both lines are active low.
+ *CTS (USART_CtsPin, any INT/PCINT capable input): while high the transmitter pauses
+ *after the byte in progress; the application routes the pin's vector to
+ *USART_CtsIRQHandling(). RTS (USART_RtsPin, any output) follows the fill level of
+ *the receive ring, see USART_RTS_HIGH_WATER/USART_RTS_LOW_WATER.
+ */
+#define USART_FLOW_NONE         0
+#define USART_FLOW_RTS          1
+#define USART_FLOW_CTS          2
+#define USART_FLOW_RTS_CTS      (USART_FLOW_RTS | USART_FLOW_CTS)
+
+/*
+ *@USART_Word9
+ *Buffer formats of the 9-bit transfers. USART_WORD9_U16: one uint16_t per word,
+ *bit 8 is the ninth bit. USART_WORD9_PACKED: groups of 8 words in 9 bytes, one byte
+ *with the ninth bits (bit i for word i of the group) then the 8 low bytes; a last
+ *partial group is the ninth-bit byte and its low bytes.
+ */
+#define USART_WORD9_NONE        0
+#define USART_WORD9_U16         1
+#define USART_WORD9_PACKED      2
+
+#define USART_PACKED9_SIZE(n)   ((n) + (((n) + 7) / 8))
+
 /*
  *@USART_NoOfStopBits
  *Possible options for USART_NoOfStopBits
@@ -111,6 +369,8 @@ typedef struct
  */
 #define USART_BUSY_IN_RX       1
 #define USART_BUSY_IN_TX       2
+#define USART_BUSY_IN_RX_RING  3
+#define USART_BUSY_IN_RX_STREAM 4
 #define USART_READY            0
 
 
@@ -122,6 +382,8 @@ typedef struct
 #define		USART_ERR_FE     	   5
 #define		USART_ERR_NE    	   6
 #define		USART_ERR_ORE    	   7
+#define		USART_EVENT_ADDR_MATCH 8
+#define		USART_EVENT_SPI_CMPLT  9
 
 /******************************************************************************************
  *                            APIs supported by this driver                               *
@@ -140,11 +402,82 @@ void USART_SendData(USART_t *pUSARTInst, uint8_t *pTxBuffer, uint32_t Len);
 void  USART_ReceiveData(USART_t *pUSARTInst,uint8_t *pRxBuffer, uint32_t Len);
 uint8_t USART_SendDataIT(USART_t *pUSARTInst,uint8_t *pTxBuffer, uint32_t Len);
 uint8_t USART_ReceiveDataIT(USART_t *pUSARTInst,uint8_t *pRxBuffer, uint32_t Len);
+uint8_t USART_SendVectorIT(USART_t *pUSARTInst, const USART_Segment_t *pSegs, uint8_t SegCnt);
+
+/*
+ * 9-bit words (bit 8 of each uint16_t is the ninth data bit)
+ */
+void    USART_SendData9(USART_t *pUSARTInst, const uint16_t *pTxBuffer, uint32_t Len);
+void    USART_ReceiveData9(USART_t *pUSARTInst, uint16_t *pRxBuffer, uint32_t Len);
+uint8_t USART_SendData9IT(USART_t *pUSARTInst, const uint16_t *pTxBuffer, uint32_t Len);
+uint8_t USART_ReceiveData9IT(USART_t *pUSARTInst, uint16_t *pRxBuffer, uint32_t Len);
+
+/*
+ * Packed 9-bit words (USART_PACKED9_SIZE bytes for Len words)
+ */
+void     USART_SendData9Packed(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len);
+void     USART_ReceiveData9Packed(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len);
+uint8_t  USART_SendData9PackedIT(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len);
+uint8_t  USART_ReceiveData9PackedIT(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len);
+void     USART_Packed9Write(uint8_t *pPacked, uint16_t Index, uint16_t Word);
+uint16_t USART_Packed9Read(const uint8_t *pPacked, uint16_t Index);
+
+/*
+ * Buffered (non-blocking) transmission
+ */
+uint16_t USART_Write(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len);
+uint16_t USART_TxFree(USART_t *pUSARTInst);
+void     USART_Flush(USART_t *pUSARTInst);
+
+/*
+ * Queued transmission (descriptors sent back to back)
+ */
+uint8_t USART_TxEnqueue(USART_t *pUSARTInst, USART_TxDesc_t *pDesc);
+uint8_t USART_TxQueueFree(USART_t *pUSARTInst);
+
+/*
+ * Buffered (always-armed) reception
+ */
+uint8_t  USART_RxRingControl(USART_t *pUSARTInst, uint8_t EnOrDi);
+uint16_t USART_Available(USART_t *pUSARTInst);
+uint16_t USART_Read(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len);
+int16_t  USART_Peek(USART_t *pUSARTInst);
+int16_t  USART_PeekAt(USART_t *pUSARTInst, uint8_t Offset);
+uint16_t USART_Discard(USART_t *pUSARTInst, uint16_t Len);
+
+/*
+ * Stream reception (every byte handed to a handler from the ISR)
+ */
+void USART_RxStreamControl(USART_t *pUSARTInst, USART_RxHandler_t pHandler);
+
+/*
+ * Multi-processor communication mode
+ */
+void USART_SendAddress(USART_t *pUSARTInst, uint8_t Address);
+
+/*
+ * Master SPI mode transfers
+ */
+void    USART_SpiTransfer(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len);
+uint8_t USART_SpiTransferIT(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len);
+
+/*
+ * Error accounting
+ */
+void USART_GetStats(USART_t *pUSARTInst, USART_Stats_t *pStats);
+void USART_ClearStats(USART_t *pUSARTInst);
+
+/*
+ * Automatic baud-rate detection
+ */
+uint8_t USART_AutoBaud(USART_t *pUSARTInst, uint16_t Timeout);
 
 /*
  * IRQ Configuration and ISR handling
  */
 void USART_IRQHandling(USART_t *pUSARTInst);
+void USART_IdleIRQHandling(USART_t *pUSARTInst);
+void USART_CtsIRQHandling(USART_t *pUSARTInst);
 
 /*
  * Other Peripheral Control APIs
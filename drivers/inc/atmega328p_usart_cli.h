@@ -0,0 +1,122 @@
+/*
+ * atmega328p_usart_cli.c
+ *
+ * Description:
+ * Line-oriented command interpreter on top of the USART receive ring.
+ * Lines are tokenized where they sit in the ring (tokens are offsets, nothing
+ * is copied), the command is looked up by binary search in a sorted table kept
+ * in flash, and handlers read their arguments through the USART_CliArgX parsers.
+ *
+ */
+
+#ifndef __ATMEGA328P_USART_CLI_H__
+#define __ATMEGA328P_USART_CLI_H__
+
+#include <avr/pgmspace.h>
+#include "atmega328p_usart.h"
+
+/******************************************************************************************
+ *                                  Driver's Specific Details                             *
+ ******************************************************************************************/
+/*
+ * Maximum number of tokens in a line, command name included.
+ */
+#ifndef USART_CLI_MAX_ARGS
+#define USART_CLI_MAX_ARGS      8
+#endif
+
+struct USART_Cli_s;
+
+/*
+ * Command table entry. The table and the names live in flash and the table
+ * must be sorted by name (plain byte order, as strcmp):
+ *
+ *   static const char name_led[] PROGMEM = "led";
+ *   static const USART_CliCmd_t cmds[] PROGMEM = { {name_led, cmd_led}, ... };
+ */
+typedef struct
+{
+    const char *pName;                                        /* !< Command name, in flash > */
+    void (*pHandler)(struct USART_Cli_s *pCliInst, uint8_t Argc); /* !< Called with the number of tokens > */
+}USART_CliCmd_t;
+
+/*
+ * Handle structure for a command interpreter
+ */
+typedef struct USART_Cli_s
+{
+    USART_t              *pUSART;                        /* !< USART instance with the Rx ring armed > */
+    const USART_CliCmd_t *pCmdTable;                     /* !< Sorted command table, in flash > */
+    uint8_t               NoOfCmds;                      /* !< Entries in pCmdTable > */
+    uint8_t               ScanOff;                       /* !< Ring bytes already searched for end of line > */
+    uint8_t               Skip;                          /* !< Dropping the rest of an overlong line > */
+    uint8_t               Argc;                          /* !< Tokens in the line being executed > */
+    uint8_t               ArgOff[USART_CLI_MAX_ARGS];    /* !< Token start, offset in the ring > */
+    uint8_t               ArgLen[USART_CLI_MAX_ARGS];    /* !< Token length > */
+}USART_Cli_t;
+
+/*
+ * Return values of USART_CliInit
+ */
+#define USART_CLI_OK            0
+#define USART_CLI_ERR_UNSORTED  1
+#define USART_CLI_ERR_BUSY      2
+
+/*
+ * Command interpreter events
+ */
+#define USART_CLI_EVENT_UNKNOWN     0   // First token is not in the table
+#define USART_CLI_EVENT_OVERFLOW    1   // Line longer than the receive ring, dropped
+#define USART_CLI_EVENT_TOO_MANY    2   // More than USART_CLI_MAX_ARGS tokens, dropped
+
+/******************************************************************************************
+ *                            APIs supported by this driver                               *
+ *             For more information about the APIs check the function definitions         *
+ ******************************************************************************************/
+/*
+ * Init and processing
+ */
+uint8_t USART_CliInit(USART_Cli_t *pCliInst, USART_t *pUSARTInst, const USART_CliCmd_t *pCmdTable, uint8_t NoOfCmds);
+void    USART_CliProcess(USART_Cli_t *pCliInst);
+
+/*
+ * Argument access (Index 0 is the command name), valid inside a handler only
+ */
+uint8_t USART_CliArgLen(USART_Cli_t *pCliInst, uint8_t Index);
+uint8_t USART_CliArgIs(USART_Cli_t *pCliInst, uint8_t Index, const char *pStr_P);
+uint8_t USART_CliArgU32(USART_Cli_t *pCliInst, uint8_t Index, uint32_t *pValue);
+uint8_t USART_CliArgI32(USART_Cli_t *pCliInst, uint8_t Index, int32_t *pValue);
+uint8_t USART_CliArgCopy(USART_Cli_t *pCliInst, uint8_t Index, char *pBuffer, uint8_t Size);
+
+/*
+ * Application Callbacks
+ */
+void USART_CliEventCallback(USART_Cli_t *pCliInst, uint8_t Event);
+
+#endif // __ATMEGA328P_USART_CLI_H__
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
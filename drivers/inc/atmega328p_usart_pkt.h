@@ -0,0 +1,104 @@
+/*
+ * atmega328p_usart_pkt.c
+ *
+ * Description:
+ * Binary packet layer on top of the USART driver. Packets are COBS encoded
+ * with a 0x00 delimiter and protected by a CRC-16/CCITT (poly 0x1021, init 0xFFFF).
+ * Encoding is streamed straight into the USART transmit ring and decoding runs
+ * byte by byte in the RX ISR, so the application only sees complete, valid packets.
+ *
+ */
+
+#ifndef __ATMEGA328P_USART_PKT_H__
+#define __ATMEGA328P_USART_PKT_H__
+
+#include "atmega328p_usart.h"
+
+/******************************************************************************************
+ *                                  Driver's Specific Details                             *
+ ******************************************************************************************/
+/*
+ * Handle structure for a packet channel
+ */
+typedef struct
+{
+    USART_t  *pUSART;           /* !< USART instance carrying the packets > */
+    uint8_t  *pRxBuffer;        /* !< App. buffer for the decoded payload + CRC > */
+    uint16_t  RxSize;           /* !< Size of pRxBuffer > */
+    uint16_t  RxLen;            /* !< Bytes decoded in the current packet > */
+    uint16_t  RxCrc;            /* !< Running CRC of the current packet > */
+    uint8_t   RxCode;           /* !< Bytes left in the current COBS block > */
+    uint8_t   RxZero;           /* !< Zero pending at the end of the current block > */
+    uint8_t   RxState;          /* !< To store Rx decoder state > */
+    uint16_t  RxDropped;        /* !< Packets dropped (bad CRC, overflow, bad framing) > */
+}USART_Pkt_t;
+
+/*
+ * Packet framing definitions
+ */
+#define USART_PKT_DELIMITER     0x00
+#define USART_PKT_CRC_LEN       2
+#define USART_PKT_CRC_INIT      0xFFFF
+
+/*
+ * Worst case encoded size of a payload of len bytes (COBS overhead, CRC and delimiter)
+ */
+#define USART_PKT_ENCODED_MAX(len)  ((len) + USART_PKT_CRC_LEN + (((len) + USART_PKT_CRC_LEN) / 254) + 2)
+
+/*
+ * Packet decoder states
+ */
+#define USART_PKT_RX_OK         0
+#define USART_PKT_RX_DISCARD    1
+
+/******************************************************************************************
+ *                            APIs supported by this driver                               *
+ *             For more information about the APIs check the function definitions         *
+ ******************************************************************************************/
+/*
+ * Init
+ */
+void USART_PktInit(USART_Pkt_t *pPktInst, USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Size);
+
+/*
+ * Packet send
+ */
+void USART_PktSend(USART_Pkt_t *pPktInst, const uint8_t *pData, uint16_t Len);
+
+/*
+ * CRC helper
+ */
+uint16_t USART_PktCrc16(uint16_t Crc, const uint8_t *pData, uint16_t Len);
+
+/*
+ * Application Callbacks
+ */
+void USART_PktReceivedCallback(USART_Pkt_t *pPktInst, uint8_t *pData, uint16_t Len);
+
+#endif // __ATMEGA328P_USART_PKT_H__
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+ * syscalls.c
+ *
+ * Description:
+ * stdio binding for the ATmega328P USART. All streams share the uart_stdio
+ * handle of the USART driver and one of three backends:
+ *  - blocking: every character polls the data register,
+ *  - buffered: stdout is queued in the TX ring and drained by the UDRE interrupt,
+ *  - interrupt: as buffered, and stdin is filled by the RXC interrupt through the RX ring.
+ *
+ */
+
+#ifndef __SYSCALLS_H__
+#define __SYSCALLS_H__
+
+#include <stdio.h>
+#include "atmega328p_usart.h"
+
+/*
+ * stdio backends (see UART_StdioInit)
+ */
+#define UART_STDIO_BLOCKING     0
+#define UART_STDIO_BUFFERED     1
+#define UART_STDIO_IT           2
+
+/*
+ * USART handle used by every stream. The ring backends need its vectors routed
+ * by the application:
+ *   ISR(ISR_USART_UDRE){ USART_IRQHandling(&uart_stdio); }   (buffered and interrupt)
+ *   ISR(ISR_USART_RX)  { USART_IRQHandling(&uart_stdio); }   (interrupt, when receiving)
+ */
+extern USART_t uart_stdio;
+
+/*
+ * stdio streams, point stdout/stdin at them after UART_StdioInit
+ */
+extern FILE uart_stdout;
+extern FILE uart_stdin;
+
+/******************************************************************************************
+ *                              APIs supported by this file
+ *                  For more information about the APIs check the function definitions
+ ******************************************************************************************/
+
+void UART_StdioInit(uint16_t baud, uint8_t mode, uint8_t backend);
+void UART_Flush(void);
+void UART_Write(const char *pData, uint16_t Len);
+
+/*
+ * Blocking 8N1 shortcuts kept for older examples, ubrr is the raw UBRR0 value
+ */
+void UART_Init(unsigned int ubrr);
+void UART_Init_Stdin(unsigned int ubrr);
+void UART_Transmit(char data);
+
+#endif /* __SYSCALLS_H__ */
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * xprintf.c
+ *
+ * Description:
+ * Small formatted output on the stdio USART (see syscalls.h), without the
+ * avr-libc vfprintf. Formats live in flash and the text goes to UART_Write in
+ * short chunks, so with the buffered backends a call returns once it is queued.
+ *
+ * Conversions: %c %s %S (string in flash) %d %u %x %X %%
+ * Flags and width: '-' left align, '0' zero pad, width 1..255 (e.g. %04x, %-8s)
+ * Length: 'l' for 32-bit arguments (%ld %lu %lx), plain conversions take int.
+ *
+ */
+
+#ifndef __XPRINTF_H__
+#define __XPRINTF_H__
+
+#include <stdarg.h>
+#include <avr/pgmspace.h>
+#include "syscalls.h"
+
+/*
+ * Characters collected on the stack before each UART_Write
+ */
+#ifndef XPRINTF_CHUNK
+#define XPRINTF_CHUNK   16
+#endif
+
+/*
+ * Format given as a literal, placed in flash by the macro
+ */
+#define xprintf(fmt, ...)   xprintf_P(PSTR(fmt), ##__VA_ARGS__)
+
+/******************************************************************************************
+ *                              APIs supported by this file
+ *                  For more information about the APIs check the function definitions
+ ******************************************************************************************/
+
+void xprintf_P(const char *pFmt_P, ...);
+void xvprintf_P(const char *pFmt_P, va_list ap);
+void xputs_P(const char *pStr_P);
+
+#endif /* __XPRINTF_H__ */
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -20,6 +20,155 @@
 
 #include "atmega328p_spi.h"
 
+/*
+ * I/O space addresses of SPSR and SPDR, for IN/OUT in the block loops.
+ * They only address the single SPI block (SPI_BASEADDR).
+ */
+#define SPI_SPSR_IOADDR     (SPI_BASEADDR + 1 - 0x20)
+#define SPI_SPDR_IOADDR     (SPI_BASEADDR + 2 - 0x20)
+
+/*********************************************************************
+ * @fn          - SPI_ConfigToRegs
+ *
+ * @brief       - Computes the SPCR/SPSR values of a configuration.
+ *
+ * @param[in]   - pConfig: Configuration to convert.
+ * @param[out]  - pRegs: SPCR value with SPE set and SPIE clear, SPSR value (SPI2X).
+ *
+ * @return      - None
+ *
+ * @note        - The configuration is only read. Run time counterpart of
+ *                SPI_CONFIG(), for configurations not known at compile time.
+ */
+void SPI_ConfigToRegs(const SPI_Config_t *pConfig, SPI_RegConfig_t *pRegs)
+{
+    uint8_t spcr = (1 << SPI_SPCR_SPE);
+    uint8_t spsr = 0;
+
+    spcr |= pConfig->Mode << SPI_SPCR_MSTR;
+    spcr |= pConfig->DataOrder << SPI_SPCR_DORD;
+    spcr |= pConfig->CPOL << SPI_SPCR_CPOL;
+    spcr |= pConfig->CPHA << SPI_SPCR_CPHA;
+
+    // Rates above SPI_SCLK_FOSC_DIV128 use the same SPR bits with SPI2X set
+    spcr |= (pConfig->SCKSpeed & SPI_SPI2X_DIS_MASK) << SPI_SPCR_SPR0;
+    if (pConfig->SCKSpeed > SPI_SCLK_FOSC_DIV128)
+    {
+        spsr |= 1 << SPI_SPSR_SPI2X;
+    }
+
+    pRegs->SPCR = spcr;
+    pRegs->SPSR = spsr;
+}
+
+/*********************************************************************
+ * @fn          - spi_it_start
+ *
+ * @brief       - Starts an interrupt driven transfer.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ * @param[in]   - pTxBuffer: Data to send, or NULL to clock out Fill.
+ * @param[out]  - pRxBuffer: Buffer for the received data, or NULL to discard it.
+ * @param[in]   - Len: Number of bytes to exchange (not 0).
+ * @param[in]   - Fill: Byte sent when pTxBuffer is NULL, kept for this transfer only.
+ * @param[in]   - State: SPI_BUSY_IN_TX, SPI_BUSY_IN_RX or SPI_BUSY_IN_TXRX, it
+ *                selects the completion event.
+ *
+ * @return      - None
+ *
+ * @note        - Both states take the job: SPI always moves one byte each way, so
+ *                there is a single transfer on the bus. The first byte is written
+ *                here, the ISR writes the others.
+ */
+static void spi_it_start(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint32_t Len, uint8_t Fill, uint8_t State)
+{
+    pSPIInst->pTxBuffer = pTxBuffer;
+    pSPIInst->pRxBuffer = pRxBuffer;
+    pSPIInst->TxLen = Len;
+    pSPIInst->JobFill = Fill;
+    pSPIInst->TxState = State;
+    pSPIInst->RxState = State;
+
+    // A stale SPIF would raise the interrupt before the first byte is out
+    if (pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF))
+    {
+        (void)pSPIInst->pReg->SPDR;
+    }
+
+    pSPIInst->pReg->SPCR |= (1 << SPI_SPCR_SPIE);
+    pSPIInst->pReg->SPDR = (pTxBuffer != NULL) ? *(pSPIInst->pTxBuffer++) : Fill;
+}
+
+/*********************************************************************
+ * @fn          - spi_xfer_next
+ *
+ * @brief       - Starts the transaction at the head of the queue if the bus is free.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - None
+ *
+ * @note        - Called with interrupts disabled: from the SPI ISR when a
+ *                transfer ends, and from SPI_XferEnqueue. The device clock mode
+ *                is loaded while every CS is still high, then CS is asserted
+ *                and the transfer engine is started. Empty transactions complete here.
+ */
+static void spi_xfer_next(SPI_t *pSPIInst)
+{
+    while (!pSPIInst->XferActive && (pSPIInst->XferHead != pSPIInst->XferTail) &&
+           (pSPIInst->TxState == SPI_READY) && (pSPIInst->RxState == SPI_READY))
+    {
+        SPI_Xfer_t *pXfer = pSPIInst->XferQueue[pSPIInst->XferTail & SPI_XFER_QUEUE_MASK];
+        const SPI_Device_t *pDev = pXfer->pDevice;
+
+        if (pXfer->Len == 0)
+        {
+            pSPIInst->XferTail++;
+            if (pXfer->pDone != NULL)
+            {
+                pXfer->pDone(pSPIInst, pXfer);
+            }
+            continue;
+        }
+
+        // Clock mode of the device, then select it
+        SPI_ApplyConfig(pSPIInst, pDev->Regs);
+        *pDev->pCsPort &= ~pDev->CsMask;
+
+        pSPIInst->XferActive = 1;
+        spi_it_start(pSPIInst, pXfer->pTxBuffer, pXfer->pRxBuffer, pXfer->Len, pSPIInst->FillByte, SPI_BUSY_IN_TXRX);
+    }
+}
+
+/*********************************************************************
+ * @fn          - spi_xfer_done
+ *
+ * @brief       - Retires the transaction that just finished and starts the next one.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - None
+ *
+ * @note        - Called from the SPI ISR with the engine already back to SPI_READY.
+ *                The slot is released before pDone, so pDone may queue again.
+ */
+static void spi_xfer_done(SPI_t *pSPIInst)
+{
+    SPI_Xfer_t *pXfer = pSPIInst->XferQueue[pSPIInst->XferTail & SPI_XFER_QUEUE_MASK];
+
+    *pXfer->pDevice->pCsPort |= pXfer->pDevice->CsMask;
+
+    pSPIInst->XferTail++;
+    pSPIInst->XferActive = 0;
+
+    if (pXfer->pDone != NULL)
+    {
+        pXfer->pDone(pSPIInst, pXfer);
+    }
+
+    spi_xfer_next(pSPIInst);
+}
+
 /*********************************************************************
  * @fn          - SPI_Init
  *
@@ -37,9 +186,16 @@
 void SPI_Init(SPI_t *pSPIInst)
 {
     // Initialization code will be added here
-    uint8_t spcr_temp = 0;
-    uint8_t spsr_temp = 0;
+    SPI_RegConfig_t regs;
     
+    // Start idle, with an empty transaction queue
+    pSPIInst->TxState = SPI_READY;
+    pSPIInst->RxState = SPI_READY;
+    pSPIInst->FillByte = SPI_DUMMY_BYTE;
+    pSPIInst->XferHead = 0;
+    pSPIInst->XferTail = 0;
+    pSPIInst->XferActive = 0;
+
     //SPI Pins configuration initialized
     GPIO_t spi_pins[] = {
         SPI_MOSI,
@@ -48,45 +204,18 @@ void SPI_Init(SPI_t *pSPIInst)
         SPI_SS
     };
 
-    //Mode configuration
-    spcr_temp |= pSPIInst->Config.Mode << SPI_SPCR_MSTR;
-
-    //Data order configuration
-    spcr_temp |= pSPIInst->Config.DataOrder << SPI_SPCR_DORD;
-
-    //Clock polarity configuration
-    spcr_temp |= pSPIInst->Config.CPOL << SPI_SPCR_CPOL;
-
-    //Clock phase configuration
-    spcr_temp |= pSPIInst->Config.CPHA << SPI_SPCR_CPHA;
-
-    // SCK baud rate configuration
-    if(pSPIInst->Config.SCKSpeed > SPI_SCLK_FOSC_DIV128)
-    {
-        //SCKSpeed formating to 2 bits
-        pSPIInst->Config.SCKSpeed &= SPI_SPI2X_DIS_MASK;
-
-        //SPI2X = 1
-        spcr_temp |= pSPIInst->Config.SCKSpeed << SPI_SPCR_SPR0;
-        spsr_temp |= 1 << SPI_SPSR_SPI2X;
-    }
-    else
-    {
-        //SPI = 0
-        spcr_temp |= pSPIInst->Config.SCKSpeed << SPI_SPCR_SPR0;
-    }
+    //Mode, data order, clock phase/polarity and rate, SPE set. Config is only read,
+    //so calling SPI_Init again with the same Config gives the same clock.
+    SPI_ConfigToRegs(&pSPIInst->Config, &regs);
 
     //SPI Pins configuration
     for (int i = 0; i < sizeof(spi_pins) / sizeof(GPIO_t); i++) {
         GPIO_Init(spi_pins[i]);
     }
 
-    //Enable SPI
-    spcr_temp |= (1<<SPI_SPCR_SPE);
-
     //Write SPI registers SPSR, SPCR
-    pSPIInst->pReg->SPCR = spcr_temp;
-    pSPIInst->pReg->SPSR = spsr_temp;
+    pSPIInst->pReg->SPCR = regs.SPCR;
+    pSPIInst->pReg->SPSR = regs.SPSR;
 
 
 }
@@ -169,22 +298,18 @@ void SPI_ReceiveData(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint32_t Len)
  * @param[in]   - pTxBuffer: Pointer to the buffer containing data to be sent.
  * @param[in]   - Len: Length of the data to be sent.
  *
- * @return      - Status indicating if the transmission was successful.
+ * @return      - SPI_READY if the transfer was started, otherwise the busy state.
  *
- * @note        - Ensure that the SPI is correctly configured for transmission.
+ * @note        - SPI_EVENT_TX_CMPLT is raised once, after the last byte was
+ *                shifted out. It may start the next transfer.
  */
 uint8_t SPI_SendDataIT(SPI_t *pSPIInst, uint8_t *pTxBuffer, uint32_t Len)
 {
     uint8_t state = pSPIInst->TxState;
 
-    if (state != SPI_BUSY_IN_TX) {
-        // Save Tx buffer and lenght in SPI instance
-        pSPIInst->pTxBuffer = pTxBuffer;
-        pSPIInst->TxLen = Len;
-        pSPIInst->TxState = SPI_BUSY_IN_TX;
-
-        // Enable interruption
-        pSPIInst->pReg->SPCR |= (1 << SPI_SPCR_SPIE);
+    if ((state == SPI_READY) && (Len > 0)) {
+        // Received bytes are discarded
+        spi_it_start(pSPIInst, pTxBuffer, NULL, Len, pSPIInst->FillByte, SPI_BUSY_IN_TX);
     }
     return state;
 }
@@ -198,26 +323,517 @@ uint8_t SPI_SendDataIT(SPI_t *pSPIInst, uint8_t *pTxBuffer, uint32_t Len)
  * @param[in]   - pRxBuffer: Pointer to the buffer where received data will be stored.
  * @param[in]   - Len: Length of the data to be received.
  *
- * @return      - Status indicating if the reception was successful.
+ * @return      - SPI_READY if the transfer was started, otherwise the busy state.
  *
- * @note        - Ensure that the SPI is correctly configured for reception.
+ * @note        - In master mode FillByte is sent to clock each byte in.
+ *                SPI_EVENT_RX_CMPLT is raised once, after the last byte.
  */
 uint8_t SPI_ReceiveDataIT(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint32_t Len)
 {
     uint8_t state = pSPIInst->RxState;
 
-    if (state != SPI_BUSY_IN_RX) {
-        // Save Rx buffer and lenght in SPI instance
-        pSPIInst->pRxBuffer = pRxBuffer;
-        pSPIInst->RxLen = Len;
-        pSPIInst->RxState = SPI_BUSY_IN_RX;
+    if ((state == SPI_READY) && (Len > 0)) {
+        // FillByte is clocked out for every received byte
+        spi_it_start(pSPIInst, NULL, pRxBuffer, Len, pSPIInst->FillByte, SPI_BUSY_IN_RX);
+    }
+    return state;
+}
 
-        // Enable interruption
-        pSPIInst->pReg->SPCR |= (1 << SPI_SPCR_SPIE);
+/*********************************************************************
+ * @fn          - SPI_TransferData
+ *
+ * @brief       - Exchanges data in both directions through the SPI peripheral.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI handle structure.
+ * @param[in]   - pTxBuffer: Data to send, or NULL to clock out FillByte.
+ * @param[out]  - pRxBuffer: Buffer for the received data, or NULL to discard it.
+ * @param[in]   - Len: Number of bytes to exchange.
+ *
+ * @return      - None
+ *
+ * @note        - Each received byte is the answer clocked in while the byte at
+ *                the same position was sent. Reading SPDR after SPIF also clears
+ *                SPIF, so no extra dummy read is needed between bytes.
+ */
+void SPI_TransferData(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len)
+{
+    uint8_t data;
+
+    while(Len > 0)
+    {
+        pSPIInst->pReg->SPDR = (pTxBuffer != NULL) ? *pTxBuffer++ : pSPIInst->FillByte;
+        while(!(pSPIInst->pReg->SPSR & (1<<SPI_SPSR_SPIF)));
+
+        data = pSPIInst->pReg->SPDR;
+        if (pRxBuffer != NULL)
+        {
+            *pRxBuffer++ = data;
+        }
+        Len--;
+    }
+}
+
+/*********************************************************************
+ * @fn          - SPI_TransferDataIT
+ *
+ * @brief       - Exchanges data in both directions using interrupts.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ * @param[in]   - pTxBuffer: Data to send, or NULL to clock out FillByte.
+ * @param[out]  - pRxBuffer: Buffer for the received data, or NULL to discard it.
+ * @param[in]   - Len: Number of bytes to exchange.
+ *
+ * @return      - SPI_READY if the transfer was started, otherwise the busy state.
+ *
+ * @note        - The first byte is written here, each SPI interrupt stores the
+ *                received byte and starts the next one. SPI_EVENT_TXRX_CMPLT is
+ *                raised once, after the last byte was received.
+ */
+uint8_t SPI_TransferDataIT(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len)
+{
+    if ((pSPIInst->TxState != SPI_READY) || (pSPIInst->RxState != SPI_READY))
+    {
+        return (pSPIInst->TxState != SPI_READY) ? pSPIInst->TxState : pSPIInst->RxState;
+    }
+
+    if (Len == 0)
+    {
+        return SPI_READY;
+    }
+
+    spi_it_start(pSPIInst, pTxBuffer, pRxBuffer, Len, pSPIInst->FillByte, SPI_BUSY_IN_TXRX);
+
+    return SPI_READY;
+}
+
+/*********************************************************************
+ * @fn          - SPI_SendBlockFast
+ *
+ * @brief       - Sends a block as close to wire speed as the CPU allows.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI handle structure.
+ * @param[in]   - pTxBuffer: Pointer to the data buffer to be transmitted.
+ * @param[in]   - Len: Length of the data to be transmitted.
+ *
+ * @return      - None
+ *
+ * @note        - The next byte is fetched while the current one shifts out, so
+ *                the loop only has to poll SPIF and store SPDR once it is set.
+ *                The loop is written in assembly, because the project builds
+ *                with -O0. It uses IN/OUT at the fixed addresses of the
+ *                ATmega328P's single SPI block, so pSPIInst->pReg must be SPI.
+ *                The setup and the final wait go through pSPIInst->pReg. At F_CPU/2 a byte takes 16 CPU cycles
+ *                on the wire. Counted from the instruction timings, one byte
+ *                every 18 or 22 cycles, depending on where SPIF falls in the
+ *                4-cycle poll (measure it with 018spi_block_bench).
+ *                Received data is discarded. Returns after the last byte was sent.
+ */
+void SPI_SendBlockFast(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint16_t Len)
+{
+    uint8_t next;
+
+    if (Len == 0)
+    {
+        return;
+    }
+
+    // A stale SPIF would let the first poll through early, clear it
+    if (pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF))
+    {
+        (void)pSPIInst->pReg->SPDR;
+    }
+
+    pSPIInst->pReg->SPDR = *pTxBuffer++;
+
+    if (--Len)
+    {
+        __asm__ volatile (
+            "1: ld   %[next], %a[buf]+      \n\t" // 2, fetched while the previous byte is on the wire
+            "2: in   __tmp_reg__, %[spsr]   \n\t" // 1
+            "   sbrs __tmp_reg__, %[spif]   \n\t" // 1, 2 once SPIF is set
+            "   rjmp 2b                     \n\t" // 2
+            "   out  %[spdr], %[next]       \n\t" // 1, clears SPIF and starts the byte
+            "   sbiw %[len], 1              \n\t" // 2
+            "   brne 1b                     \n\t" // 2
+            : [buf] "+e" (pTxBuffer), [len] "+w" (Len), [next] "=&r" (next)
+            : [spsr] "I" (SPI_SPSR_IOADDR), [spdr] "I" (SPI_SPDR_IOADDR), [spif] "I" (SPI_SPSR_SPIF)
+            : "memory"
+        );
+    }
+
+    while (!(pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)));
+}
+
+/*********************************************************************
+ * @fn          - SPI_ReadBlock
+ *
+ * @brief       - Reads a block in master mode, clocking the bus with a fill byte.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI handle structure.
+ * @param[out]  - pRxBuffer: Buffer for the received data.
+ * @param[in]   - Len: Number of bytes to read.
+ * @param[in]   - Fill: Byte sent for every byte read (0xFF or 0x00 for most devices).
+ *
+ * @return      - None
+ *
+ * @note        - One byte on the bus at a time, as SPI_TransferData.
+ */
+void SPI_ReadBlock(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill)
+{
+    while(Len > 0)
+    {
+        pSPIInst->pReg->SPDR = Fill;
+        while(!(pSPIInst->pReg->SPSR & (1<<SPI_SPSR_SPIF)));
+
+        *pRxBuffer++ = pSPIInst->pReg->SPDR;
+        Len--;
+    }
+}
+
+/*********************************************************************
+ * @fn          - SPI_ReadBlockIT
+ *
+ * @brief       - Reads a block in master mode using interrupts.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ * @param[out]  - pRxBuffer: Buffer for the received data.
+ * @param[in]   - Len: Number of bytes to read.
+ * @param[in]   - Fill: Byte sent for every byte read.
+ *
+ * @return      - SPI_READY if the transfer was started, otherwise the busy state.
+ *
+ * @note        - Fill is only used by this transfer, FillByte is left as it was.
+ *                SPI_EVENT_RX_CMPLT is raised once, after the last byte.
+ */
+uint8_t SPI_ReadBlockIT(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill)
+{
+    uint8_t state = pSPIInst->RxState;
+
+    if ((state == SPI_READY) && (Len > 0)) {
+        spi_it_start(pSPIInst, NULL, pRxBuffer, Len, Fill, SPI_BUSY_IN_RX);
     }
     return state;
 }
 
+/*********************************************************************
+ * @fn          - SPI_ReadBlockFast
+ *
+ * @brief       - Reads a block in master mode as close to wire speed as the CPU allows.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI handle structure.
+ * @param[out]  - pRxBuffer: Buffer for the received data.
+ * @param[in]   - Len: Number of bytes to read.
+ * @param[in]   - Fill: Byte sent for every byte read.
+ *
+ * @return      - None
+ *
+ * @note        - The next fill byte is written as soon as the received one was
+ *                read from SPDR, and the store to pRxBuffer happens while the
+ *                next byte shifts in. As in SPI_SendBlockFast, the loop is written
+ *                in assembly with IN/OUT at the fixed addresses of the single SPI
+ *                block, so pSPIInst->pReg must be SPI. The setup and the last
+ *                byte go through pSPIInst->pReg. Counted from the instruction timings, one
+ *                byte every 19 or 23 cycles at F_CPU/2 (measure it with
+ *                018spi_block_bench).
+ */
+void SPI_ReadBlockFast(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len, uint8_t Fill)
+{
+    uint8_t data;
+
+    if (Len == 0)
+    {
+        return;
+    }
+
+    // A stale SPIF would let the first poll through early, clear it
+    if (pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF))
+    {
+        (void)pSPIInst->pReg->SPDR;
+    }
+
+    pSPIInst->pReg->SPDR = Fill;
+
+    if (--Len)
+    {
+        __asm__ volatile (
+            "1: in   __tmp_reg__, %[spsr]   \n\t" // 1
+            "   sbrs __tmp_reg__, %[spif]   \n\t" // 1, 2 once SPIF is set
+            "   rjmp 1b                     \n\t" // 2
+            "   in   %[data], %[spdr]       \n\t" // 1, clears SPIF
+            "   out  %[spdr], %[fill]       \n\t" // 1, starts the next byte
+            "   st   %a[buf]+, %[data]      \n\t" // 2, stored while the next byte is on the wire
+            "   sbiw %[len], 1              \n\t" // 2
+            "   brne 1b                     \n\t" // 2
+            : [buf] "+e" (pRxBuffer), [len] "+w" (Len), [data] "=&r" (data)
+            : [fill] "r" (Fill), [spsr] "I" (SPI_SPSR_IOADDR), [spdr] "I" (SPI_SPDR_IOADDR), [spif] "I" (SPI_SPSR_SPIF)
+            : "memory"
+        );
+    }
+
+    while (!(pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)));
+    *pRxBuffer = pSPIInst->pReg->SPDR;
+}
+
+/*********************************************************************
+ * @fn          - SPI_DeviceInit
+ *
+ * @brief       - Prepares a device descriptor for the transaction queue.
+ *
+ * @param[out]  - pDevice: Descriptor to fill.
+ * @param[in]   - pRegs: Clock mode, data order and rate of the device, from
+ *                SPI_CONFIG(MASTER, ...) or SPI_ConfigToRegs.
+ * @param[in]   - CsPin: Chip select pin of the device (MODE_OUT), active low.
+ *
+ * @return      - None
+ *
+ * @note        - The register values are copied into the descriptor, switching
+ *                devices is then two register stores. The CS pin is driven high before
+ *                it becomes an output, so the device is never selected by a
+ *                glitch. The port is shared with the queue's CS writes, so both
+ *                bits are set with interrupts disabled.
+ */
+void SPI_DeviceInit(SPI_Device_t *pDevice, const SPI_RegConfig_t *pRegs, GPIO_t CsPin)
+{
+    uint8_t sreg;
+
+    pDevice->Regs = *pRegs;
+
+    pDevice->pCsPort = CsPin.GPIOX.PORT;
+    pDevice->CsMask = (uint8_t)(1 << CsPin.GPIO_Pin.Number);
+
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+
+    // Deselected level first, then the output driver
+    *CsPin.GPIOX.PORT |= pDevice->CsMask;
+    *CsPin.GPIOX.DDR |= pDevice->CsMask;
+
+    CPU_SREG_REG = sreg;
+}
+
+/*********************************************************************
+ * @fn          - SPI_XferEnqueue
+ *
+ * @brief       - Queues a transaction behind the ones already pending.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure (SPI_Init done).
+ * @param[in]   - pXfer: Transaction to run.
+ *
+ * @return      - SPI_READY if queued, SPI_BUSY_IN_TXRX if the queue is full.
+ *
+ * @note        - Transactions run back to back from SPI_IRQHandling: the driver
+ *                loads the device clock mode, asserts its CS, exchanges Len bytes,
+ *                releases CS and calls pDone before starting the next one. The
+ *                transaction and its buffers belong to the driver until pDone.
+ *                May be called from thread context and from pDone. Blocking
+ *                transfers must not be used while the queue is running.
+ */
+uint8_t SPI_XferEnqueue(SPI_t *pSPIInst, SPI_Xfer_t *pXfer)
+{
+    uint8_t head;
+    uint8_t sreg = CPU_SREG_REG;
+
+    IRQ_DIS();
+
+    head = pSPIInst->XferHead;
+
+    if ((uint8_t)(head - pSPIInst->XferTail) >= SPI_XFER_QUEUE_SIZE)
+    {
+        CPU_SREG_REG = sreg;
+        return SPI_BUSY_IN_TXRX;
+    }
+
+    pSPIInst->XferQueue[head & SPI_XFER_QUEUE_MASK] = pXfer;
+    pSPIInst->XferHead = head + 1;
+
+    // Start right away if the bus is idle
+    spi_xfer_next(pSPIInst);
+
+    CPU_SREG_REG = sreg;
+
+    return SPI_READY;
+}
+
+/*********************************************************************
+ * @fn          - SPI_XferQueueFree
+ *
+ * @brief       - Returns the number of free slots in the transaction queue.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - Number of transactions that SPI_XferEnqueue accepts right now.
+ *
+ * @note        - None
+ */
+uint8_t SPI_XferQueueFree(SPI_t *pSPIInst)
+{
+    return SPI_XFER_QUEUE_SIZE - (uint8_t)(pSPIInst->XferHead - pSPIInst->XferTail);
+}
+
+/*********************************************************************
+ * @fn          - SPI_SlaveStart
+ *
+ * @brief       - Starts the slave mode engine.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure (SPI_Init done
+ *                with Mode = SPI_MODE_SLAVE).
+ * @param[in]   - pCmds: Command table, or NULL to exchange a plain byte stream.
+ * @param[in]   - CmdCount: Entries in pCmds.
+ *
+ * @return      - None
+ *
+ * @note        - The SPI ISR answers every byte in place. With a table, a known
+ *                command byte is answered with SPI_SLAVE_ACK_BYTE and an unknown
+ *                one with SPI_SLAVE_NACK_BYTE. Then the ArgLen bytes after the
+ *                master's ack read are collected and the handler runs. Bytes the
+ *                handler queues with SPI_SlaveWrite go out on the next clocks.
+ *                The handler returns how many data bytes the master sends next,
+ *                and they are stored in the Rx ring. Without a table every
+ *                received byte goes to the Rx ring, and the Tx ring (or FillByte)
+ *                is sent back. Calling it again resynchronises the protocol.
+ *                Each reply is loaded into SPDR by the ISR of the previous byte, so
+ *                the master must wait at least one SPI ISR run (handler included,
+ *                plus any other interrupt that may delay it) before clocking the
+ *                next byte. A byte clocked sooner reads back the master's own
+ *                previous byte. SS (PB2) is watched through PCINT0: call
+ *                SPI_SlaveSsIRQHandling from ISR(ISR_PCINT0).
+ */
+void SPI_SlaveStart(SPI_t *pSPIInst, const SPI_SlaveCmd_t *pCmds, uint8_t CmdCount)
+{
+    GPIO_t ss = SPI_SS;
+    uint8_t sreg = CPU_SREG_REG;
+
+    IRQ_DIS();
+
+    pSPIInst->pReg->SPCR &= ~(1 << SPI_SPCR_SPIE);
+
+    pSPIInst->pSlaveCmds = pCmds;
+    pSPIInst->SlaveCmdCount = CmdCount;
+    pSPIInst->pSlaveCmd = NULL;
+    pSPIInst->SlaveState = SPI_SLAVE_IDLE;
+    pSPIInst->SlaveReply = 0;
+    pSPIInst->SlaveRxHead = 0;
+    pSPIInst->SlaveRxTail = 0;
+    pSPIInst->SlaveTxHead = 0;
+    pSPIInst->SlaveTxTail = 0;
+
+    // The master IT transfers stay off while the slave engine owns the ISR
+    pSPIInst->TxState = SPI_BUSY_IN_SLAVE;
+    pSPIInst->RxState = SPI_BUSY_IN_SLAVE;
+
+    if (pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF))
+    {
+        (void)pSPIInst->pReg->SPDR;
+    }
+
+    // Reply of the first byte
+    pSPIInst->pReg->SPDR = pSPIInst->FillByte;
+    pSPIInst->pReg->SPCR |= (1 << SPI_SPCR_SPIE);
+
+    // SS going high ends the command in progress
+    GPIO_ConfigInterrupt(&ss, INT_LOGICAL_CHANGE);
+    GPIO_EnableInterrupt(&ss);
+
+    CPU_SREG_REG = sreg;
+}
+
+/*********************************************************************
+ * @fn          - SPI_SlaveStop
+ *
+ * @brief       - Stops the slave mode engine.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - None
+ *
+ * @note        - Bytes left in the rings are kept until the next SPI_SlaveStart.
+ */
+void SPI_SlaveStop(SPI_t *pSPIInst)
+{
+    GPIO_t ss = SPI_SS;
+
+    GPIO_DisableInterrupt(&ss);
+    pSPIInst->pReg->SPCR &= ~(1 << SPI_SPCR_SPIE);
+    pSPIInst->TxState = SPI_READY;
+    pSPIInst->RxState = SPI_READY;
+}
+
+/*********************************************************************
+ * @fn          - SPI_SlaveWrite
+ *
+ * @brief       - Queues reply bytes for the master.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ * @param[in]   - pTxBuffer: Bytes to send.
+ * @param[in]   - Len: Number of bytes.
+ *
+ * @return      - Number of bytes queued, less than Len when the Tx ring is full.
+ *
+ * @note        - Each byte is loaded into SPDR by the ISR of the previous byte,
+ *                so it is sent on the next byte the master clocks. Call it from the
+ *                command handlers or from thread context, not from both.
+ */
+uint16_t SPI_SlaveWrite(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint16_t Len)
+{
+    uint8_t head = pSPIInst->SlaveTxHead;
+    uint16_t count = 0;
+
+    while ((count < Len) && ((uint8_t)(head - pSPIInst->SlaveTxTail) < SPI_SLAVE_RING_SIZE))
+    {
+        pSPIInst->SlaveTx[head & SPI_SLAVE_RING_MASK] = pTxBuffer[count++];
+        head++;
+    }
+
+    pSPIInst->SlaveTxHead = head;
+
+    return count;
+}
+
+/*********************************************************************
+ * @fn          - SPI_SlaveAvailable
+ *
+ * @brief       - Returns the number of bytes waiting in the slave Rx ring.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - Bytes that SPI_SlaveRead can return right now.
+ *
+ * @note        - None
+ */
+uint16_t SPI_SlaveAvailable(SPI_t *pSPIInst)
+{
+    return (uint8_t)(pSPIInst->SlaveRxHead - pSPIInst->SlaveRxTail);
+}
+
+/*********************************************************************
+ * @fn          - SPI_SlaveRead
+ *
+ * @brief       - Copies bytes out of the slave Rx ring.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ * @param[out]  - pRxBuffer: Destination buffer.
+ * @param[in]   - Len: Size of pRxBuffer.
+ *
+ * @return      - Number of bytes copied (0 when the ring is empty).
+ *
+ * @note        - Bytes received while the ring is full are dropped.
+ */
+uint16_t SPI_SlaveRead(SPI_t *pSPIInst, uint8_t *pRxBuffer, uint16_t Len)
+{
+    uint8_t tail = pSPIInst->SlaveRxTail;
+    uint16_t count = 0;
+
+    while ((count < Len) && (tail != pSPIInst->SlaveRxHead))
+    {
+        pRxBuffer[count++] = pSPIInst->SlaveRx[tail & SPI_SLAVE_RING_MASK];
+        tail++;
+    }
+
+    pSPIInst->SlaveRxTail = tail;
+
+    return count;
+}
+
 /*********************************************************************
  * @fn          - SPI_Control
  *
@@ -270,86 +886,240 @@ void SPI_IRQInterruptConfig(SPI_t *pSPIInst, uint8_t EnorDi)
 }
 
 /*********************************************************************
- * @fn          - SPI_IRQHandling
+ * @fn          - spi_it_interrupt_handle
  *
- * @brief       - Handles the SPI interrupt when it is triggered.
+ * @brief       - Handles the SPI interrupt of a transfer started by spi_it_start.
  *
  * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
  *
  * @return      - None
  *
- * @note        - This function should handle the SPI interrupt and manage any pending flags.
+ * @note        - One entry per byte: SPSR was read by the caller, reading SPDR
+ *                here clears SPIF, then the next byte is written. At the end the
+ *                engine is back to SPI_READY before the single completion event,
+ *                so the callback can start the next transfer.
  */
-void SPI_IRQHandling(SPI_t *pSPIInst)
+static void spi_it_interrupt_handle(SPI_t *pSPIInst)
 {
-    //Check if SPI interrupt is active and if SPI is bussy Tx.
-    if ((pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)) && (pSPIInst->TxState == SPI_BUSY_IN_TX)) {
-        spi_txe_interrupt_handle(pSPIInst);
+    uint8_t data = pSPIInst->pReg->SPDR;
+    uint8_t state;
+
+    if (pSPIInst->pRxBuffer != NULL) {
+        *(pSPIInst->pRxBuffer++) = data;
+    }
+
+    if (--pSPIInst->TxLen > 0) {
+        // Start the next byte right away
+        pSPIInst->pReg->SPDR = (pSPIInst->pTxBuffer != NULL) ? *(pSPIInst->pTxBuffer++) : pSPIInst->JobFill;
+        return;
+    }
+
+    // Transfer completed
+    state = pSPIInst->TxState;
+    pSPIInst->TxState = SPI_READY;
+    pSPIInst->RxState = SPI_READY;
+    pSPIInst->pReg->SPCR &= ~(1 << SPI_SPCR_SPIE); // Disable the interrupt
+
+    if (pSPIInst->XferActive) {
+        // Queued transaction: release CS, notify it and chain the next one
+        spi_xfer_done(pSPIInst);
+        return;
+    }
+
+    // Call the callback
+    if (state == SPI_BUSY_IN_TX) {
+        SPI_ApplicationEventCallback(pSPIInst, SPI_EVENT_TX_CMPLT);
     }
-    //Check if SPI interrupt is active and if SPI is bussy Rx.
-    if ((pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)) && (pSPIInst->RxState == SPI_BUSY_IN_RX)) {
-        spi_rxne_interrupt_handle(pSPIInst);
+    else if (state == SPI_BUSY_IN_RX) {
+        SPI_ApplicationEventCallback(pSPIInst, SPI_EVENT_RX_CMPLT);
+    }
+    else {
+        SPI_ApplicationEventCallback(pSPIInst, SPI_EVENT_TXRX_CMPLT);
     }
+
+    // Transactions queued meanwhile
+    spi_xfer_next(pSPIInst);
 }
 
 /*********************************************************************
- * @fn          - spi_txe_interrupt_handle
+ * @fn          - spi_slave_run
  *
- * @brief       - Handles the SPI transmit interrupt event.
+ * @brief       - Runs the handler of the slave command in progress.
  *
  * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
  *
  * @return      - None
  *
- * @note        - This function should manage the transmission of data when the transmit interrupt is triggered.
+ * @note        - Called from the SPI ISR once all the arguments are in.
  */
-static void  spi_txe_interrupt_handle(SPI_t *pSPIInst)
+static void spi_slave_run(SPI_t *pSPIInst)
 {
-    if (pSPIInst->TxLen > 0) {
-        // Write register SPDR
-        pSPIInst->pReg->SPDR = *(pSPIInst->pTxBuffer);
-        pSPIInst->pTxBuffer++;
-        pSPIInst->TxLen--;
+    const SPI_SlaveCmd_t *pCmd = pSPIInst->pSlaveCmd;
+    uint8_t data_len = 0;
+
+    if (pCmd->pHandler != NULL)
+    {
+        data_len = pCmd->pHandler(pSPIInst, pSPIInst->SlaveArgs);
     }
 
-    if (pSPIInst->TxLen == 0) {
-        // Transmission completed
-        pSPIInst->TxState = SPI_READY;
-        pSPIInst->pReg->SPCR &= ~(1 << SPI_SPCR_SPIE); // Disable the interrupt
+    pSPIInst->SlaveCount = data_len;
+    pSPIInst->SlaveState = (data_len > 0) ? SPI_SLAVE_DATA : SPI_SLAVE_IDLE;
+}
 
-        // Call the callback
-        SPI_ApplicationEventCallback(pSPIInst, SPI_EVENT_TX_CMPLT);
+/*********************************************************************
+ * @fn          - spi_slave_interrupt_handle
+ *
+ * @brief       - Handles the SPI interrupt of the slave mode engine.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - None
+ *
+ * @note        - The next reply must be in SPDR before the master clocks the next
+ *                byte. It is loaded right after the protocol step, before the Rx
+ *                ring is updated. Command handlers run inside this window, so
+ *                keep them short or have the master pause after the arguments.
+ */
+static void spi_slave_interrupt_handle(SPI_t *pSPIInst)
+{
+    uint8_t data = pSPIInst->pReg->SPDR;
+    uint8_t store = 0;
+    uint8_t reply = 0;
+    uint8_t out;
+    uint8_t i;
+
+    switch (pSPIInst->SlaveState)
+    {
+        case SPI_SLAVE_IDLE:
+            if (pSPIInst->pSlaveCmds == NULL) {
+                // Plain byte stream
+                store = 1;
+            }
+            else if (!pSPIInst->SlaveReply) {
+                // Not a filler byte clocking a reply out: it is a command
+                reply = SPI_SLAVE_NACK_BYTE;
+                for (i = 0; i < pSPIInst->SlaveCmdCount; i++) {
+                    if (pSPIInst->pSlaveCmds[i].Code == data) {
+                        pSPIInst->pSlaveCmd = &pSPIInst->pSlaveCmds[i];
+                        pSPIInst->SlaveState = SPI_SLAVE_ACK;
+                        reply = SPI_SLAVE_ACK_BYTE;
+                        break;
+                    }
+                }
+            }
+            break;
+
+        case SPI_SLAVE_ACK:
+            // Filler byte of the ack read
+            pSPIInst->SlaveCount = 0;
+            if (pSPIInst->pSlaveCmd->ArgLen == 0) {
+                spi_slave_run(pSPIInst);
+            }
+            else {
+                pSPIInst->SlaveState = SPI_SLAVE_ARGS;
+            }
+            break;
+
+        case SPI_SLAVE_ARGS:
+            if (pSPIInst->SlaveCount < SPI_SLAVE_ARGS_MAX) {
+                pSPIInst->SlaveArgs[pSPIInst->SlaveCount] = data;
+            }
+            pSPIInst->SlaveCount++;
+            if (pSPIInst->SlaveCount >= pSPIInst->pSlaveCmd->ArgLen) {
+                spi_slave_run(pSPIInst);
+            }
+            break;
+
+        default: // SPI_SLAVE_DATA
+            store = 1;
+            if (--pSPIInst->SlaveCount == 0) {
+                pSPIInst->SlaveState = SPI_SLAVE_IDLE;
+            }
+            break;
+    }
+
+    // Preload the reply of the next byte
+    if (reply) {
+        out = reply;
+        pSPIInst->SlaveReply = 1;
+    }
+    else if (pSPIInst->SlaveTxTail != pSPIInst->SlaveTxHead) {
+        out = pSPIInst->SlaveTx[pSPIInst->SlaveTxTail & SPI_SLAVE_RING_MASK];
+        pSPIInst->SlaveTxTail++;
+        pSPIInst->SlaveReply = 1;
+    }
+    else {
+        out = pSPIInst->FillByte;
+        pSPIInst->SlaveReply = 0;
+    }
+    pSPIInst->pReg->SPDR = out;
+
+    if (store && ((uint8_t)(pSPIInst->SlaveRxHead - pSPIInst->SlaveRxTail) < SPI_SLAVE_RING_SIZE)) {
+        pSPIInst->SlaveRx[pSPIInst->SlaveRxHead & SPI_SLAVE_RING_MASK] = data;
+        pSPIInst->SlaveRxHead++;
     }
 }
 
 /*********************************************************************
- * @fn          - spi_rxne_interrupt_handle
+ * @fn          - SPI_IRQHandling
  *
- * @brief       - Handles the SPI receive not empty interrupt event.
+ * @brief       - Handles the SPI interrupt when it is triggered.
  *
  * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
  *
  * @return      - None
  *
- * @note        - This function should process incoming data when the receive not empty interrupt is triggered.
+ * @note        - Sending, receiving and full-duplex transfers share one engine,
+ *                SPIF is only serviced while one of them or the slave engine
+ *                is running.
  */
-static void  spi_rxne_interrupt_handle(SPI_t *pSPIInst)
+void SPI_IRQHandling(SPI_t *pSPIInst)
 {
-    if (pSPIInst->RxLen > 0) {
-        // Write register SPDR
-        *(pSPIInst->pRxBuffer) = pSPIInst->pReg->SPDR;
-        pSPIInst->pRxBuffer++;
-        pSPIInst->RxLen--;
+    //Check if SPI interrupt is active and if the slave engine is running.
+    if ((pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)) && (pSPIInst->TxState == SPI_BUSY_IN_SLAVE)) {
+        spi_slave_interrupt_handle(pSPIInst);
+    }
+    //Check if SPI interrupt is active and if SPI is bussy.
+    else if ((pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF)) && (pSPIInst->TxState != SPI_READY)) {
+        spi_it_interrupt_handle(pSPIInst);
     }
+}
 
-    if (pSPIInst->RxLen == 0) {
-        // Reception completed
-        pSPIInst->RxState = SPI_READY;
-        pSPIInst->pReg->SPCR &= ~(1 << SPI_SPCR_SPIE); // Disable the interrupt
+/*********************************************************************
+ * @fn          - SPI_SlaveSsIRQHandling
+ *
+ * @brief       - Handles a change of the SS line while the slave engine runs.
+ *
+ * @param[in]   - pSPIInst: Pointer to the SPI instance structure.
+ *
+ * @return      - None
+ *
+ * @note        - Call it from ISR(ISR_PCINT0), other PORTB pins sharing the
+ *                vector are ignored. When SS goes high the command in progress
+ *                is dropped, replies not clocked out are discarded and FillByte
+ *                is preloaded, so the next frame starts with a command byte.
+ *                A plain byte stream (no command table) is left untouched.
+ */
+void SPI_SlaveSsIRQHandling(SPI_t *pSPIInst)
+{
+    if ((pSPIInst->TxState != SPI_BUSY_IN_SLAVE) || (pSPIInst->pSlaveCmds == NULL) ||
+        !(*SPI_GPIO_PORT.PIN & (1 << SPI_SS_PIN)))
+    {
+        return;
+    }
 
-        // Call the callback
-        SPI_ApplicationEventCallback(pSPIInst, SPI_EVENT_RX_CMPLT);
+    // PCINT0 is served before the SPI vector, finish the last byte of the frame
+    if (pSPIInst->pReg->SPSR & (1 << SPI_SPSR_SPIF))
+    {
+        spi_slave_interrupt_handle(pSPIInst);
     }
+
+    pSPIInst->pSlaveCmd = NULL;
+    pSPIInst->SlaveState = SPI_SLAVE_IDLE;
+    pSPIInst->SlaveCount = 0;
+    pSPIInst->SlaveReply = 0;
+    pSPIInst->SlaveTxTail = pSPIInst->SlaveTxHead;
+    pSPIInst->pReg->SPDR = pSPIInst->FillByte;
 }
 
 /*********************************************************************
@@ -17,215 +17,1945 @@
 
 #include "atmega328p_usart.h"
 
+/*********************************************************************
+ * @fn            - usart_mpcm_control
+ *
+ * @brief         - Sets or clears the MPCM0 bit without disturbing UCSR0A flags.
+ *
+ * @param[in]     - pUSARTRegs: Pointer to the USART registers.
+ * @param[in]     - EnOrDi: ENABLE to filter data frames, DISABLE to receive them.
+ *
+ * @return        - None
+ *
+ * @Note          - TXC0 is cleared by writing one, so only U2X0 is written back.
+ */
+static void usart_mpcm_control(USART_Regs_t *pUSARTRegs, uint8_t EnOrDi)
+{
+    pUSARTRegs->UCSR0A = (pUSARTRegs->UCSR0A & (1 << USART_UCSR0A_U2X0)) |
+                         ((EnOrDi == ENABLE) ? (1 << USART_UCSR0A_MPCM0) : 0);
+}
+
+/*********************************************************************
+ * @fn            - usart_stat_inc
+ *
+ * @brief         - Increments an error counter without wrapping around.
+ *
+ * @param[in]     - pCounter: Pointer to the counter.
+ *
+ * @return        - None
+ *
+ * @Note          - None
+ */
+static void usart_stat_inc(volatile uint16_t *pCounter)
+{
+    if (*pCounter != 0xFFFF)
+    {
+        (*pCounter)++;
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_rx_error_handle
+ *
+ * @brief         - Accounts the receive errors flagged in UCSR0A and notifies the application.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - status: UCSR0A value read before UDR0.
+ *
+ * @return        - None
+ *
+ * @Note          - FE0, DOR0 and UPE0 describe the byte at the top of the receive
+ *                  buffer and are only valid until UDR0 is read.
+ */
+static void usart_rx_error_handle(USART_t *pUSARTInst, uint8_t status)
+{
+    if (status & (1 << USART_UCSR0A_FE0))
+    {
+        usart_stat_inc(&pUSARTInst->Stats.FrameErrors);
+        USART_ApplicationEventCallback(pUSARTInst, USART_ERR_FE);
+    }
+
+    if (status & (1 << USART_UCSR0A_DOR0))
+    {
+        usart_stat_inc(&pUSARTInst->Stats.OverrunErrors);
+        USART_ApplicationEventCallback(pUSARTInst, USART_ERR_ORE);
+    }
+
+    if (status & (1 << USART_UCSR0A_UPE0))
+    {
+        usart_stat_inc(&pUSARTInst->Stats.ParityErrors);
+        USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_PE);
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_mspim_init
+ *
+ * @brief         - Configures the USART as a Master SPI (MSPIM) bus.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - The datasheet requires UBRR0 = 0 while the transmitter is
+ *                  enabled, and the real rate to be written afterwards.
+ */
+static void usart_mspim_init(USART_t *pUSARTInst)
+{
+    GPIO_t xck = USART_XCK;
+    uint8_t mode = pUSARTInst->Config.USART_SpiMode;
+
+    pUSARTInst->pReg->UBRR0L = 0;
+    pUSARTInst->pReg->UBRR0H = 0;
+
+    // XCK0 must be an output for the USART to act as master
+    GPIO_Init(xck);
+
+    // MSPIM, data order, clock phase and polarity
+    pUSARTInst->pReg->UCSR0C = (1 << USART_UCSR0C_UMSEL01) | (1 << USART_UCSR0C_UMSEL00) |
+                               ((pUSARTInst->Config.USART_DataOrder & 0x01) << USART_UCSR0C_UDORD0) |
+                               ((mode & 0x01) << USART_UCSR0C_UCPHA0) |
+                               (((mode >> 1) & 0x01) << USART_UCSR0C_UCPOL0);
+
+    // Both directions are always used, SPI is full duplex
+    pUSARTInst->pReg->UCSR0A = 0;
+    pUSARTInst->pReg->UCSR0B = (1 << USART_UCSR0B_RXEN0) | (1 << USART_UCSR0B_TXEN0);
+
+    pUSARTInst->pReg->UBRR0L = (uint8_t)(pUSARTInst->Config.USART_Baud & 0x00FF);
+    pUSARTInst->pReg->UBRR0H = (uint8_t)((pUSARTInst->Config.USART_Baud >> 8) & 0x0F);
+}
+
+/*********************************************************************
+ * @fn            - usart_mspim_rxc_handle
+ *
+ * @brief         - Advances an interrupt-driven Master SPI transfer by one byte.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - data: Byte clocked in with the byte that just finished.
+ *
+ * @return        - None
+ *
+ * @Note          - Two bytes are kept in flight so the double-buffered
+ *                  transmitter never runs dry.
+ */
+static void usart_mspim_rxc_handle(USART_t *pUSARTInst, uint8_t data)
+{
+    if (pUSARTInst->RxLen == 0)
+    {
+        return;
+    }
+
+    if (pUSARTInst->pRxBuffer != NULL)
+    {
+        *(pUSARTInst->pRxBuffer++) = data;
+    }
+    pUSARTInst->RxLen--;
+
+    if (pUSARTInst->TxLen > 0)
+    {
+        // Refill the transmitter, 0xFF is clocked out when there is no Tx data
+        pUSARTInst->pReg->UDR0 = (pUSARTInst->pTxBuffer != NULL) ? *(pUSARTInst->pTxBuffer++) : 0xFF;
+        pUSARTInst->TxLen--;
+    }
+
+    if (pUSARTInst->RxLen == 0)
+    {
+        // Transfer complete, disable RXCIE
+        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_RXCIE0);
+        pUSARTInst->TxBusyState = USART_READY;
+        pUSARTInst->RxBusyState = USART_READY;
+
+        // Notify application of SPI transfer complete
+        USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_SPI_CMPLT);
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_baud_write
+ *
+ * @brief         - Loads a USART_Baud value (UBRR0 plus U2X0 flag) into the registers.
+ *
+ * @param[in]     - pUSARTRegs: Pointer to the USART registers.
+ * @param[in]     - baud: UBRR0 value, ORed with USART_BAUD_U2X for double speed.
+ *
+ * @return        - None
+ *
+ * @Note          - UBRR0H goes first, writing UBRR0L updates the prescaler.
+ *                  MPCM0 is preserved and TXC0 is not touched.
+ */
+static void usart_baud_write(USART_Regs_t *pUSARTRegs, uint16_t baud)
+{
+    pUSARTRegs->UCSR0A = (pUSARTRegs->UCSR0A & (1 << USART_UCSR0A_MPCM0)) |
+                         ((baud & USART_BAUD_U2X) ? (1 << USART_UCSR0A_U2X0) : 0);
+    pUSARTRegs->UBRR0H = (uint8_t)((baud >> 8) & 0x0F);
+    pUSARTRegs->UBRR0L = (uint8_t)(baud & 0x00FF);
+}
+
+/*********************************************************************
+ * @fn            - usart_autobaud_wait
+ *
+ * @brief         - Waits for a level on RXD0 (PD0) with a timeout.
+ *
+ * @param[in]     - level: 0 to wait for low, non-zero to wait for high.
+ * @param[in]     - limit: Timeout in Timer1 overflows, 0 waits forever.
+ * @param[in,out] - pOvf: Overflows counted so far.
+ *
+ * @return        - 1 when the level was reached, 0 on timeout.
+ *
+ * @Note          - Used before the measurement, where the timing is not critical.
+ */
+static uint8_t usart_autobaud_wait(uint8_t level, uint32_t limit, uint16_t *pOvf)
+{
+    uint8_t want = level ? (1 << PIN0) : 0;
+
+    while ((*GPIO_PIND_REG_ADDR & (1 << PIN0)) != want)
+    {
+        if (TIM1_TIFR1_REG & (1 << TIM1_TIFR1_TOV1))
+        {
+            TIM1_TIFR1_REG = (1 << TIM1_TIFR1_TOV1);
+            if ((limit != 0) && (++(*pOvf) >= limit))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*********************************************************************
+ * @fn            - usart_autobaud_edge
+ *
+ * @brief         - Busy-waits until the RXD0 (PD0) pin reaches a level.
+ *
+ * @param[in]     - level: 0 to wait for low, non-zero to wait for high.
+ *
+ * @return        - 1 when the level was reached, 0 if the line stayed put
+ *                  for about 65536 polls.
+ *
+ * @Note          - Kept as short as possible: its period is the timing jitter.
+ */
+static uint8_t usart_autobaud_edge(uint8_t level)
+{
+    uint8_t want = level ? (1 << PIN0) : 0;
+    uint16_t guard = 0xFFFF;
+
+    while ((*GPIO_PIND_REG_ADDR & (1 << PIN0)) != want)
+    {
+        if (--guard == 0)
+            return 0;
+    }
+
+    return 1;
+}
+
+/*********************************************************************
+ * @fn            - usart_idle_init
+ *
+ * @brief         - Programs Timer2 to measure USART_IdleTime half characters.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - Timer2 runs in CTC mode with the smallest prescaler that fits
+ *                  the gap in 8 bits. The compare interrupt is armed by the first
+ *                  received frame.
+ */
+static void usart_idle_init(USART_t *pUSARTInst)
+{
+    // Timer2 prescalers 1, 8, 32, 64, 128, 256, 1024 as shifts (CS22:0 = 1..7)
+    static const uint8_t shift[] = {0, 3, 5, 6, 7, 8, 10};
+    uint16_t baud = pUSARTInst->Config.USART_Baud;
+    uint8_t bits;
+    uint32_t cycles;
+    uint8_t cs;
+
+    // Frame length: start + data + parity + stop bits
+    if ((pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS) ||
+        (pUSARTInst->Config.USART_MPCM == ENABLE))
+        bits = 1 + 9;
+    else
+        bits = 1 + 5 + pUSARTInst->Config.USART_WordLength;
+    if (pUSARTInst->Config.USART_ParityControl != USART_PARITY_DISABLE)
+        bits++;
+    bits += (pUSARTInst->Config.USART_NoOfStopBits == USART_STOPBITS_2) ? 2 : 1;
+
+    // CPU cycles per bit are (UBRR0 + 1) * 16, or * 8 with U2X0
+    cycles = ((uint32_t)(baud & USART_BAUD_UBRR_MASK) + 1) * ((baud & USART_BAUD_U2X) ? 8 : 16);
+    cycles = (cycles * bits * pUSARTInst->Config.USART_IdleTime) / 2;
+
+    for (cs = 0; cs < sizeof(shift) - 1; cs++)
+    {
+        if ((cycles >> shift[cs]) <= 256)
+            break;
+    }
+
+    cycles = (cycles + (1UL << shift[cs]) - 1) >> shift[cs];
+    if (cycles > 256)
+        cycles = 256;
+    if (cycles == 0)
+        cycles = 1;
+
+    TIM2_TIMSK2_REG &= ~(1 << TIM2_TIMSK2_OCIE2A);
+    TIM2->TCCR2B = 0;
+    TIM2->TCCR2A = (1 << TIM2_TCCR2A_WGM21);
+    TIM2->TCNT2 = 0;
+    TIM2->OCR2A = (uint8_t)(cycles - 1);
+    TIM2->TCCR2B = cs + 1;
+}
+
+/*********************************************************************
+ * @fn            - usart_idle_restart
+ *
+ * @brief         - Restarts the idle-line gap after a received frame.
+ *
+ * @param[in]     - None
+ *
+ * @return        - None
+ *
+ * @Note          - The prescaler is not reset, so the gap may be up to one
+ *                  timer tick shorter than requested.
+ */
+static void usart_idle_restart(void)
+{
+    TIM2->TCNT2 = 0;
+    TIM2_TIFR2_REG = (1 << TIM2_TIFR2_OCF2A);
+    TIM2_TIMSK2_REG |= (1 << TIM2_TIMSK2_OCIE2A);
+}
+
+/*********************************************************************
+ * @fn            - usart_cts_blocked
+ *
+ * @brief         - Tells whether the peer currently forbids transmission.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - 1 if CTS flow control is enabled and CTS is high, 0 otherwise.
+ *
+ * @Note          - Reads the PIN register directly, it runs in the UDRE ISR.
+ */
+static uint8_t usart_cts_blocked(USART_t *pUSARTInst)
+{
+    if (!(pUSARTInst->Config.USART_FlowControl & USART_FLOW_CTS))
+    {
+        return 0;
+    }
+
+    return (*pUSARTInst->Config.USART_CtsPin.GPIOX.PIN & (1 << pUSARTInst->Config.USART_CtsPin.GPIO_Pin.Number)) != 0;
+}
+
+/*********************************************************************
+ * @fn            - usart_rts_write
+ *
+ * @brief         - Drives the RTS line.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - level: 0 to let the peer send (asserted), 1 to hold it off.
+ *
+ * @return        - None
+ *
+ * @Note          - The port is shared with the application, so the
+ *                  read-modify-write runs with interrupts disabled.
+ */
+static void usart_rts_write(USART_t *pUSARTInst, uint8_t level)
+{
+    uint8_t mask = (1 << pUSARTInst->Config.USART_RtsPin.GPIO_Pin.Number);
+    uint8_t sreg = CPU_SREG_REG;
+    IRQ_DIS();
+
+    if (level)
+        *pUSARTInst->Config.USART_RtsPin.GPIOX.PORT |= mask;
+    else
+        *pUSARTInst->Config.USART_RtsPin.GPIOX.PORT &= ~mask;
+
+    CPU_SREG_REG = sreg;
+}
+
+/*********************************************************************
+ * @fn            - usart_flow_init
+ *
+ * @brief         - Configures the RTS/CTS pins selected in USART_FlowControl.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - RTS starts asserted, the receiver is ready from the start.
+ */
+static void usart_flow_init(USART_t *pUSARTInst)
+{
+    if (pUSARTInst->Config.USART_FlowControl & USART_FLOW_RTS)
+    {
+        GPIO_t *pRts = &pUSARTInst->Config.USART_RtsPin;
+
+        usart_rts_write(pUSARTInst, 0);
+        *pRts->GPIOX.DDR |= (1 << pRts->GPIO_Pin.Number);
+    }
+
+    if (pUSARTInst->Config.USART_FlowControl & USART_FLOW_CTS)
+    {
+        // Work on a copy, the configuration is left as the application wrote it
+        GPIO_t cts = pUSARTInst->Config.USART_CtsPin;
+
+        cts.GPIO_Pin.Mode = MODE_IN;
+        GPIO_Init(cts);
+        pUSARTInst->CtsLevel = usart_cts_blocked(pUSARTInst);
+
+        // Both edges matter: high pauses the transmitter, low resumes it
+        GPIO_ConfigInterrupt(&cts, INT_LOGICAL_CHANGE);
+        GPIO_EnableInterrupt(&cts);
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_rx_release
+ *
+ * @brief         - Hands consumed receive ring slots back to the RXC ISR.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - tail: New read index.
+ *
+ * @return        - None
+ *
+ * @Note          - Also asserts RTS again once the ring drained below the
+ *                  low watermark.
+ */
+static void usart_rx_release(USART_t *pUSARTInst, uint8_t tail)
+{
+    // Release the consumed bytes to the ISR with a single store
+    pUSARTInst->RxTail = tail;
+
+    // Let the peer resume once the ring drained below the low watermark
+    if ((pUSARTInst->Config.USART_FlowControl & USART_FLOW_RTS) &&
+        ((uint8_t)(pUSARTInst->RxHead - tail) <= USART_RTS_LOW_WATER))
+    {
+        usart_rts_write(pUSARTInst, 0);
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_put9
+ *
+ * @brief         - Loads a 9-bit word into the transmitter.
+ *
+ * @param[in]     - pUSARTRegs: Pointer to the USART registers.
+ * @param[in]     - word: Word to send, bit 8 goes to TXB80.
+ *
+ * @return        - None
+ *
+ * @Note          - UDR0 must be empty. TXB80 is written before UDR0, as the
+ *                  datasheet requires, and UCSR0B is updated atomically because
+ *                  the ISR also changes its interrupt enables.
+ */
+static void usart_put9(USART_Regs_t *pUSARTRegs, uint16_t word)
+{
+    uint8_t sreg = CPU_SREG_REG;
+
+    IRQ_DIS();
+    if (word & 0x0100)
+        pUSARTRegs->UCSR0B |= (1 << USART_UCSR0B_TXB80);
+    else
+        pUSARTRegs->UCSR0B &= ~(1 << USART_UCSR0B_TXB80);
+    CPU_SREG_REG = sreg;
+
+    pUSARTRegs->UDR0 = (uint8_t)word;
+}
+
+/*********************************************************************
+ * @fn            - usart_tx9_end
+ *
+ * @brief         - Clears TXB80 once the last 9-bit word left UDR0.
+ *
+ * @param[in]     - pUSARTRegs: Pointer to the USART registers.
+ *
+ * @return        - None
+ *
+ * @Note          - TXB80 is copied to the shift register with UDR0, so it is only
+ *                  cleared when UDR0 is empty. Byte transfers that follow then go
+ *                  out as data frames.
+ */
+static void usart_tx9_end(USART_Regs_t *pUSARTRegs)
+{
+    uint8_t sreg;
+
+    while (!(pUSARTRegs->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTRegs->UCSR0B &= ~(1 << USART_UCSR0B_TXB80);
+    CPU_SREG_REG = sreg;
+}
+
+/*********************************************************************
+ * @fn            - usart_word9_fetch
+ *
+ * @brief         - Reads the next 9-bit word of an interrupt transmission.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - Word to send, bit 8 is the ninth bit.
+ *
+ * @Note          - Follows TxWord9 (@USART_Word9) and advances pTxBuffer.
+ */
+static uint16_t usart_word9_fetch(USART_t *pUSARTInst)
+{
+    uint16_t word;
+
+    if (pUSARTInst->TxWord9 == USART_WORD9_PACKED)
+    {
+        // A group starts with its ninth bits
+        if (pUSARTInst->TxPos9 == 0)
+        {
+            pUSARTInst->TxBits9 = *(pUSARTInst->pTxBuffer++);
+        }
+        word = ((uint16_t)(pUSARTInst->TxBits9 & 0x01) << 8) | *(pUSARTInst->pTxBuffer++);
+        pUSARTInst->TxBits9 >>= 1;
+        pUSARTInst->TxPos9 = (pUSARTInst->TxPos9 + 1) & 0x07;
+    }
+    else
+    {
+        word = *(const uint16_t *)pUSARTInst->pTxBuffer;
+        pUSARTInst->pTxBuffer += 2;
+    }
+
+    return word;
+}
+
+/*********************************************************************
+ * @fn            - usart_word9_store
+ *
+ * @brief         - Stores a received 9-bit word of an interrupt reception.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - rxb8: Ninth bit (RXB80).
+ * @param[in]     - data: Low byte (UDR0).
+ *
+ * @return        - None
+ *
+ * @Note          - Follows RxWord9 (@USART_Word9) and advances pRxBuffer.
+ */
+static void usart_word9_store(USART_t *pUSARTInst, uint8_t rxb8, uint8_t data)
+{
+    if (pUSARTInst->RxWord9 == USART_WORD9_PACKED)
+    {
+        // A group starts with its ninth bits, filled in as the words arrive
+        if (pUSARTInst->RxPos9 == 0)
+        {
+            pUSARTInst->pRxBits9 = pUSARTInst->pRxBuffer++;
+            *pUSARTInst->pRxBits9 = 0;
+        }
+        if (rxb8)
+        {
+            *pUSARTInst->pRxBits9 |= (1 << pUSARTInst->RxPos9);
+        }
+        *(pUSARTInst->pRxBuffer++) = data;
+        pUSARTInst->RxPos9 = (pUSARTInst->RxPos9 + 1) & 0x07;
+    }
+    else
+    {
+        *(uint16_t *)pUSARTInst->pRxBuffer = (rxb8 ? 0x0100 : 0x0000) | data;
+        pUSARTInst->pRxBuffer += 2;
+    }
+}
+
+/*********************************************************************
+ * @fn            - usart_txq_handle
+ *
+ * @brief         - Sends the next byte of the transmission queue.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - Called from the UDRE branch while the queue is not empty. The
+ *                  descriptor is retired as soon as its last byte is in UDR0, so
+ *                  the next one starts on the following UDRE without waiting for
+ *                  TXC. Empty descriptors are retired in the same call.
+ */
+static void usart_txq_handle(USART_t *pUSARTInst)
+{
+    while (pUSARTInst->TxQHead != pUSARTInst->TxQTail)
+    {
+        uint8_t tail = pUSARTInst->TxQTail;
+        USART_TxDesc_t *pDesc = pUSARTInst->TxQueue[tail & USART_TX_QUEUE_MASK];
+        uint8_t sent = 0;
+
+        if (!pUSARTInst->TxQLoaded)
+        {
+            pUSARTInst->pTxQData = pDesc->pData;
+            pUSARTInst->TxQLen = pDesc->Len;
+            pUSARTInst->TxQLoaded = 1;
+        }
+
+        if (pUSARTInst->TxQLen > 0)
+        {
+            pUSARTInst->pReg->UDR0 = *(pUSARTInst->pTxQData++);
+            pUSARTInst->TxQLen--;
+            sent = 1;
+
+            // Clear TXC0 (write one) so USART_Flush can tell when this byte left the wire
+            pUSARTInst->pReg->UCSR0A = (pUSARTInst->pReg->UCSR0A & ((1 << USART_UCSR0A_U2X0) | (1 << USART_UCSR0A_MPCM0))) |
+                                       (1 << USART_UCSR0A_TXC0);
+            pUSARTInst->TxRingActive = 1;
+
+            if (pUSARTInst->TxQLen > 0)
+            {
+                return;
+            }
+        }
+
+        // Last byte loaded: release the descriptor before calling back, so the
+        // callback may queue it (or another one) again
+        pUSARTInst->TxQLoaded = 0;
+        pUSARTInst->TxQTail = tail + 1;
+
+        if (pDesc->pDone != NULL)
+        {
+            pDesc->pDone(pUSARTInst, pDesc);
+        }
+
+        if (sent)
+        {
+            return;
+        }
+    }
+}
+
 /*********************************************************************
  * @fn            - USART_Init
  *
- * @brief         - Initializes the USART peripheral with the specified configurations.
- *                 This includes setting the mode (e.g., TX, RX), number of stop bits,
- *                 word length, parity control, and baud rate as defined in the configuration structure.
- *                 
- *                 The baud rate is configured considering a system clock of 16 MHz.
+ * @brief         - Initializes the USART peripheral with the specified configurations.
+ *                 This includes setting the mode (e.g., TX, RX), number of stop bits,
+ *                 word length, parity control, and baud rate as defined in the configuration structure.
+ *                 
+ *                 USART_Baud is expected to come from USART_BAUD(), which already
+ *                 holds the UBRR0 value and the U2X0 (double speed) selection for F_CPU.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - Ensure that the USART clock is enabled before calling this function.
+ */
+void USART_Init(USART_t *pUSARTInst)
+{
+    // Start with empty transmit and receive rings.
+    pUSARTInst->TxHead = 0;
+    pUSARTInst->TxTail = 0;
+    pUSARTInst->RxHead = 0;
+    pUSARTInst->RxTail = 0;
+    pUSARTInst->TxRingActive = 0;
+    pUSARTInst->TxQHead = 0;
+    pUSARTInst->TxQTail = 0;
+    pUSARTInst->TxQLoaded = 0;
+
+    // Start with clean error counters.
+    USART_ClearStats(pUSARTInst);
+
+    // Master SPI mode has its own frame format.
+    if (pUSARTInst->Config.USART_Mode == USART_MODE_MSPIM)
+    {
+        usart_mspim_init(pUSARTInst);
+        return;
+    }
+
+    // Configure the USART mode (RX, TX, or RX/TX).
+    uint8_t ucsr0b = 0;
+    if (pUSARTInst->Config.USART_Mode != USART_MODE_ONLY_TX)
+        ucsr0b |= (1 << USART_UCSR0B_RXEN0);  // Enable RX if needed.
+    if (pUSARTInst->Config.USART_Mode != USART_MODE_ONLY_RX)
+        ucsr0b |= (1 << USART_UCSR0B_TXEN0);  // Enable TX if needed.
+    pUSARTInst->pReg->UCSR0B = ucsr0b;
+
+    // Configure the USART word length (5, 6, 7, 8 or 9 bits).
+    // Multi-processor communication mode always uses 9 bit frames.
+    // 9 bits uses UCSZ02:0 = 111, so UCSZ01:0 must be set as for 8 bits.
+    if ((pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS) ||
+        (pUSARTInst->Config.USART_MPCM == ENABLE))
+    {
+        pUSARTInst->pReg->UCSR0C = (USART_WORDLEN_8BITS & 0x03) << USART_UCSR0C_UCSZ00;
+        pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UCSZ02);
+    }
+    else
+    {
+        pUSARTInst->pReg->UCSR0C = (pUSARTInst->Config.USART_WordLength & 0x03) << USART_UCSR0C_UCSZ00;
+        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_UCSZ02);
+    }
+
+    // Configure the number of stop bits.
+    if (pUSARTInst->Config.USART_NoOfStopBits == USART_STOPBITS_2)
+        pUSARTInst->pReg->UCSR0C |= (1 << USART_UCSR0C_USBS0);
+    else
+        pUSARTInst->pReg->UCSR0C &= ~(1 << USART_UCSR0C_USBS0);
+
+    // Configure the parity control (even/odd/no parity).
+    pUSARTInst->pReg->UCSR0C |= (pUSARTInst->Config.USART_ParityControl & 0x03) << USART_UCSR0C_UPM00;
+
+    // Configure the USART baud rate.
+    // UBRR0 and U2X0 were computed at build time by USART_BAUD() from F_CPU.
+    usart_baud_write(pUSARTInst->pReg, pUSARTInst->Config.USART_Baud);
+
+    // In MPCM the receiver starts by ignoring data frames until its address is seen.
+    usart_mpcm_control(pUSARTInst->pReg, pUSARTInst->Config.USART_MPCM);
+
+    // Idle-line detection for frames delimited by a silent gap.
+    if (pUSARTInst->Config.USART_IdleTime != 0)
+    {
+        usart_idle_init(pUSARTInst);
+    }
+
+    // RTS/CTS hardware flow control.
+    if (pUSARTInst->Config.USART_FlowControl != USART_FLOW_NONE)
+    {
+        usart_flow_init(pUSARTInst);
+    }
+}
+
+
+/*********************************************************************
+ * @fn            - USART_DeInit
+ *
+ * @brief         - Deinitializes the USART peripheral and resets its registers.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - This function resets the USART to its default state.
+ */
+void USART_DeInit(USART_t *pUSARTInst)
+{
+    // Reset all USART registers to zero
+    pUSARTInst->pReg->UCSR0A = 0x00;
+    pUSARTInst->pReg->UCSR0B = 0x00;
+    pUSARTInst->pReg->UCSR0C = 0x00;
+    pUSARTInst->pReg->UBRR0L = 0x00;
+    pUSARTInst->pReg->UBRR0H = 0x00;
+
+    // Release Timer2 if it was measuring the idle line
+    if (pUSARTInst->Config.USART_IdleTime != 0)
+    {
+        TIM2_TIMSK2_REG &= ~(1 << TIM2_TIMSK2_OCIE2A);
+        TIM2->TCCR2B = 0x00;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_SendData
+ *
+ * @brief         - Sends data via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Pointer to the transmission buffer.
+ * @param[in]     - Len: Length of the data to be sent.
+ *
+ * @return        - None
+ *
+ * @Note          - Blocks until all data is sent. In 9-bit mode every byte is sent
+ *                  with the ninth bit cleared, use USART_SendData9 for full words.
+ */
+void USART_SendData(USART_t *pUSARTInst, uint8_t *pTxBuffer, uint32_t Len)
+{
+    // A byte cannot carry the ninth bit: in 9-bit mode bytes go out as data frames.
+    // TXB80 travels with UDR0, so it is only changed once UDR0 is empty.
+    if ((pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS) && (Len > 0))
+    {
+        uint8_t sreg;
+
+        while(!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+        sreg = CPU_SREG_REG;
+        IRQ_DIS();
+        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_TXB80);
+        CPU_SREG_REG = sreg;
+    }
+
+    // Loop through the data to be sent
+    for(uint32_t i = 0; i < Len; i++)
+    {
+        // Wait until the transmit buffer is ready for new data
+        while(!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+        // Wait while the peer holds CTS high
+        while(usart_cts_blocked(pUSARTInst));
+
+        // Transmit the data
+        pUSARTInst->pReg->UDR0 = *pTxBuffer;
+
+        // Move to the next byte in the buffer
+        pTxBuffer++;
+    }
+
+    if (Len > 0)
+    {
+        // Clear TXC0 (write one) after the last byte so USART_Flush can tell when it left the wire
+        pUSARTInst->pReg->UCSR0A = (pUSARTInst->pReg->UCSR0A & ((1 << USART_UCSR0A_U2X0) | (1 << USART_UCSR0A_MPCM0))) |
+                                   (1 << USART_UCSR0A_TXC0);
+        pUSARTInst->TxRingActive = 1;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveData
+ *
+ * @brief         - Receives data via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pRxBuffer: Pointer to the reception buffer.
+ * @param[in]     - Len: Length of the data to be received.
+ *
+ * @return        - None
+ *
+ * @Note          - Blocks until all data is received. In 9-bit mode only the
+ *                  low 8 bits are stored, use USART_ReceiveData9 for full words.
+ */
+void USART_ReceiveData(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint32_t Len)
+{
+    // Loop through the length of data to be received
+    for (uint32_t i = 0; i < Len; i++)
+    {
+        // Wait until there is data in the receive buffer
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_RXC0)));
+
+        // Read the received data (in 9-bit mode RXB80 is dropped, see USART_ReceiveData9)
+        *pRxBuffer = pUSARTInst->pReg->UDR0;
+
+        // Move to the next byte in the buffer
+        pRxBuffer++;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_SendDataIT
+ *
+ * @brief         - Sends data via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Pointer to the transmission buffer.
+ * @param[in]     - Len: Length of the data to be sent.
+ *
+ * @return        - USART_BUSY_IN_TX if transmission is ongoing, USART_READY otherwise.
+ *
+ * @Note          - This function uses interrupts for data transmission.
+ */
+uint8_t USART_SendDataIT(USART_t *pUSARTInst, uint8_t *pTxBuffer, uint32_t Len)
+{
+    if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+    {
+        return USART_BUSY_IN_TX;
+    }
+
+    // Save transmission details
+    pUSARTInst->pTxBuffer = pTxBuffer;
+    pUSARTInst->TxLen = Len;
+    pUSARTInst->TxSegCnt = 0;
+    pUSARTInst->TxWord9 = USART_WORD9_NONE;
+    pUSARTInst->TxBusyState = USART_BUSY_IN_TX;
+
+    // Enable Data Register Empty interrupt (UDRIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_SendVectorIT
+ *
+ * @brief         - Sends a list of segments via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pSegs: Array of (pointer, length) segments to send back to back.
+ * @param[in]     - SegCnt: Number of segments in the array.
+ *
+ * @return        - USART_BUSY_IN_TX if transmission is ongoing, USART_READY otherwise.
+ *
+ * @Note          - The UDRE interrupt walks the segments in place, so neither the
+ *                  segment array nor the data may change before USART_EVENT_TX_CMPLT.
+ */
+uint8_t USART_SendVectorIT(USART_t *pUSARTInst, const USART_Segment_t *pSegs, uint8_t SegCnt)
+{
+    uint8_t sreg;
+
+    if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+    {
+        return USART_BUSY_IN_TX;
+    }
+
+    if (SegCnt == 0)
+    {
+        return USART_READY;
+    }
+
+    // Start with the first segment, the ISR picks up the rest
+    pUSARTInst->pTxBuffer = pSegs[0].pData;
+    pUSARTInst->TxLen = pSegs[0].Len;
+    pUSARTInst->pTxSeg = &pSegs[1];
+    pUSARTInst->TxSegCnt = SegCnt - 1;
+    pUSARTInst->TxWord9 = USART_WORD9_NONE;
+    pUSARTInst->TxBusyState = USART_BUSY_IN_TX;
+
+    // Enable Data Register Empty interrupt (UDRIE)
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    CPU_SREG_REG = sreg;
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_SendData9
+ *
+ * @brief         - Sends 9-bit words via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Words to send, bit 8 is the ninth data bit.
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - None
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Blocks until the last word left UDR0,
+ *                  then clears TXB80 so later byte transfers send data frames.
+ */
+void USART_SendData9(USART_t *pUSARTInst, const uint16_t *pTxBuffer, uint32_t Len)
+{
+    for (uint32_t i = 0; i < Len; i++)
+    {
+        // Wait until the transmit buffer is ready for new data
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+        // Wait while the peer holds CTS high
+        while (usart_cts_blocked(pUSARTInst));
+
+        usart_put9(pUSARTInst->pReg, *pTxBuffer++);
+    }
+
+    if (Len > 0)
+    {
+        usart_tx9_end(pUSARTInst->pReg);
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveData9
+ *
+ * @brief         - Receives 9-bit words via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[out]    - pRxBuffer: Received words, bit 8 is the ninth data bit.
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - None
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Blocks until all words are received.
+ */
+void USART_ReceiveData9(USART_t *pUSARTInst, uint16_t *pRxBuffer, uint32_t Len)
+{
+    for (uint32_t i = 0; i < Len; i++)
+    {
+        // Wait until there is data in the receive buffer
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_RXC0)));
+
+        // RXB80 must be read before UDR0, reading UDR0 moves the next frame in
+        uint16_t word = (pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_RXB80)) ? 0x0100 : 0x0000;
+
+        *pRxBuffer++ = word | pUSARTInst->pReg->UDR0;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_SendData9IT
+ *
+ * @brief         - Sends 9-bit words via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Words to send, bit 8 is the ninth data bit.
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - USART_BUSY_IN_TX if transmission is ongoing, USART_READY otherwise.
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Completion is reported with
+ *                  USART_EVENT_TX_CMPLT, as for USART_SendDataIT. TXB80 is
+ *                  cleared once the last word left UDR0.
+ */
+uint8_t USART_SendData9IT(USART_t *pUSARTInst, const uint16_t *pTxBuffer, uint32_t Len)
+{
+    uint8_t sreg;
+
+    if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+    {
+        return USART_BUSY_IN_TX;
+    }
+
+    // Save transmission details, the ISR steps through the words two bytes at a time
+    pUSARTInst->pTxBuffer = (const uint8_t *)pTxBuffer;
+    pUSARTInst->TxLen = Len;
+    pUSARTInst->TxSegCnt = 0;
+    pUSARTInst->TxWord9 = USART_WORD9_U16;
+    pUSARTInst->TxBusyState = USART_BUSY_IN_TX;
+
+    // Enable Data Register Empty interrupt (UDRIE)
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    CPU_SREG_REG = sreg;
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveData9IT
+ *
+ * @brief         - Receives 9-bit words via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[out]    - pRxBuffer: Received words, bit 8 is the ninth data bit.
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - USART_BUSY_IN_RX if reception is ongoing, USART_BUSY_IN_RX_RING
+ *                  if the receive ring is armed, USART_READY otherwise.
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Completion is reported with
+ *                  USART_EVENT_RX_CMPLT. With MPCM enabled, address frames are
+ *                  still consumed by the address filter and not stored.
+ */
+uint8_t USART_ReceiveData9IT(USART_t *pUSARTInst, uint16_t *pRxBuffer, uint32_t Len)
+{
+    if (pUSARTInst->RxBusyState != USART_READY)
+    {
+        return pUSARTInst->RxBusyState;
+    }
+
+    // Save reception details
+    pUSARTInst->pRxBuffer = (uint8_t *)pRxBuffer;
+    pUSARTInst->RxLen = Len;
+    pUSARTInst->RxWord9 = USART_WORD9_U16;
+    pUSARTInst->RxBusyState = USART_BUSY_IN_RX;
+
+    // Enable RX Complete interrupt (RXCIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_SendData9Packed
+ *
+ * @brief         - Sends packed 9-bit words via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Packed words (@USART_Word9, USART_PACKED9_SIZE(Len) bytes).
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - None
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Same behaviour as USART_SendData9
+ *                  with 9 bits of RAM per word.
+ */
+void USART_SendData9Packed(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len)
+{
+    uint8_t bits = 0;
+
+    for (uint16_t i = 0; i < Len; i++)
+    {
+        // A group starts with its ninth bits
+        if ((i & 0x07) == 0)
+        {
+            bits = *pTxBuffer++;
+        }
+
+        // Wait until the transmit buffer is ready for new data
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+        // Wait while the peer holds CTS high
+        while (usart_cts_blocked(pUSARTInst));
+
+        usart_put9(pUSARTInst->pReg, ((uint16_t)(bits & 0x01) << 8) | *pTxBuffer++);
+        bits >>= 1;
+    }
+
+    if (Len > 0)
+    {
+        usart_tx9_end(pUSARTInst->pReg);
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveData9Packed
+ *
+ * @brief         - Receives packed 9-bit words via USART in blocking mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[out]    - pRxBuffer: Packed words (@USART_Word9, USART_PACKED9_SIZE(Len) bytes).
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - None
+ *
+ * @Note          - Needs USART_WORDLEN_9BITS. Blocks until all words are received.
+ */
+void USART_ReceiveData9Packed(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len)
+{
+    uint8_t *pBits = pRxBuffer;
+
+    for (uint16_t i = 0; i < Len; i++)
+    {
+        // A group starts with its ninth bits, filled in as the words arrive
+        if ((i & 0x07) == 0)
+        {
+            pBits = pRxBuffer++;
+            *pBits = 0;
+        }
+
+        // Wait until there is data in the receive buffer
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_RXC0)));
+
+        // RXB80 must be read before UDR0, reading UDR0 moves the next frame in
+        if (pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_RXB80))
+        {
+            *pBits |= (1 << (i & 0x07));
+        }
+        *pRxBuffer++ = pUSARTInst->pReg->UDR0;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_SendData9PackedIT
+ *
+ * @brief         - Sends packed 9-bit words via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Packed words (@USART_Word9, USART_PACKED9_SIZE(Len) bytes).
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - USART_BUSY_IN_TX if transmission is ongoing, USART_READY otherwise.
+ *
+ * @Note          - As USART_SendData9IT.
+ */
+uint8_t USART_SendData9PackedIT(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len)
+{
+    uint8_t sreg;
+
+    if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+    {
+        return USART_BUSY_IN_TX;
+    }
+
+    // Save transmission details, the ISR unpacks one word at a time
+    pUSARTInst->pTxBuffer = pTxBuffer;
+    pUSARTInst->TxLen = Len;
+    pUSARTInst->TxSegCnt = 0;
+    pUSARTInst->TxWord9 = USART_WORD9_PACKED;
+    pUSARTInst->TxPos9 = 0;
+    pUSARTInst->TxBusyState = USART_BUSY_IN_TX;
+
+    // Enable Data Register Empty interrupt (UDRIE)
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    CPU_SREG_REG = sreg;
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveData9PackedIT
+ *
+ * @brief         - Receives packed 9-bit words via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[out]    - pRxBuffer: Packed words (@USART_Word9, USART_PACKED9_SIZE(Len) bytes).
+ * @param[in]     - Len: Number of words.
+ *
+ * @return        - USART_BUSY_IN_RX if reception is ongoing, USART_BUSY_IN_RX_RING
+ *                  if the receive ring is armed, USART_READY otherwise.
+ *
+ * @Note          - As USART_ReceiveData9IT.
+ */
+uint8_t USART_ReceiveData9PackedIT(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len)
+{
+    if (pUSARTInst->RxBusyState != USART_READY)
+    {
+        return pUSARTInst->RxBusyState;
+    }
+
+    // Save reception details
+    pUSARTInst->pRxBuffer = pRxBuffer;
+    pUSARTInst->RxLen = Len;
+    pUSARTInst->RxWord9 = USART_WORD9_PACKED;
+    pUSARTInst->RxPos9 = 0;
+    pUSARTInst->RxBusyState = USART_BUSY_IN_RX;
+
+    // Enable RX Complete interrupt (RXCIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_Packed9Write
+ *
+ * @brief         - Stores one word in a packed 9-bit buffer.
+ *
+ * @param[out]    - pPacked: Packed buffer (@USART_Word9).
+ * @param[in]     - Index: Word index.
+ * @param[in]     - Word: Word to store, bit 8 is the ninth bit.
+ *
+ * @return        - None
+ *
+ * @Note          - None
+ */
+void USART_Packed9Write(uint8_t *pPacked, uint16_t Index, uint16_t Word)
+{
+    uint8_t *pGroup = pPacked + (Index >> 3) * 9;
+    uint8_t mask = (1 << (Index & 0x07));
+
+    if (Word & 0x0100)
+        pGroup[0] |= mask;
+    else
+        pGroup[0] &= ~mask;
+
+    pGroup[1 + (Index & 0x07)] = (uint8_t)Word;
+}
+
+/*********************************************************************
+ * @fn            - USART_Packed9Read
+ *
+ * @brief         - Reads one word of a packed 9-bit buffer.
+ *
+ * @param[in]     - pPacked: Packed buffer (@USART_Word9).
+ * @param[in]     - Index: Word index.
+ *
+ * @return        - The word, bit 8 is the ninth bit.
+ *
+ * @Note          - None
+ */
+uint16_t USART_Packed9Read(const uint8_t *pPacked, uint16_t Index)
+{
+    const uint8_t *pGroup = pPacked + (Index >> 3) * 9;
+    uint16_t word = pGroup[1 + (Index & 0x07)];
+
+    if (pGroup[0] & (1 << (Index & 0x07)))
+    {
+        word |= 0x0100;
+    }
+    return word;
+}
+
+/*********************************************************************
+ * @fn            - USART_ReceiveDataIT
+ *
+ * @brief         - Receives data via USART in interrupt mode.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pRxBuffer: Pointer to the reception buffer.
+ * @param[in]     - Len: Length of the data to be received.
+ *
+ * @return        - USART_BUSY_IN_RX if reception is ongoing, USART_BUSY_IN_RX_RING
+ *                  if the receive ring is armed, USART_READY otherwise.
+ *
+ * @Note          - This function uses interrupts for data reception.
+ */
+uint8_t USART_ReceiveDataIT(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint32_t Len)
+{
+    if (pUSARTInst->RxBusyState != USART_READY)
+    {
+        return pUSARTInst->RxBusyState;
+    }
+
+    // Save reception details
+    pUSARTInst->pRxBuffer = pRxBuffer;
+    pUSARTInst->RxLen = Len;
+    pUSARTInst->RxWord9 = USART_WORD9_NONE;
+    pUSARTInst->RxBusyState = USART_BUSY_IN_RX;
+
+    // Enable RX Complete interrupt (RXCIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_Write
+ *
+ * @brief         - Queues data into the transmit ring without blocking.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pTxBuffer: Pointer to the data to be queued.
+ * @param[in]     - Len: Number of bytes to queue.
+ *
+ * @return        - Number of bytes actually queued (less than Len if the ring is full).
+ *
+ * @Note          - Single producer only: call it from thread context, the UDRE
+ *                  branch of USART_IRQHandling is the single consumer.
+ */
+uint16_t USART_Write(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint16_t Len)
+{
+    uint8_t head = pUSARTInst->TxHead;
+    uint8_t sreg;
+
+    // Clip the request to the free space in the ring
+    if (Len > USART_TxFree(pUSARTInst))
+    {
+        Len = USART_TxFree(pUSARTInst);
+    }
+
+    if (Len == 0)
+    {
+        return 0;
+    }
+
+    // Copy the data into the ring
+    for (uint16_t i = 0; i < Len; i++)
+    {
+        pUSARTInst->TxRing[head & USART_TX_RING_MASK] = pTxBuffer[i];
+        head++;
+    }
+
+    // Publish the new bytes to the ISR with a single store
+    pUSARTInst->TxHead = head;
+
+    // Enable UDRIE; UCSR0B is also modified by the ISR so update it atomically
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    CPU_SREG_REG = sreg;
+
+    return Len;
+}
+
+/*********************************************************************
+ * @fn            - USART_TxFree
+ *
+ * @brief         - Returns the free space in the transmit ring.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - Number of bytes that USART_Write can queue right now.
+ *
+ * @Note          - None
+ */
+uint16_t USART_TxFree(USART_t *pUSARTInst)
+{
+    return USART_TX_RING_SIZE - (uint8_t)(pUSARTInst->TxHead - pUSARTInst->TxTail);
+}
+
+/*********************************************************************
+ * @fn            - USART_Flush
+ *
+ * @brief         - Waits until the transmit ring and queue are empty and the last byte was sent.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - If called with global interrupts disabled the ring is drained
+ *                  by polling, so it never deadlocks.
+ */
+void USART_Flush(USART_t *pUSARTInst)
+{
+    while ((pUSARTInst->TxHead != pUSARTInst->TxTail) || (pUSARTInst->TxQHead != pUSARTInst->TxQTail))
+    {
+        if (!(CPU_SREG_REG & (1 << 7)))
+        {
+            // Interrupts are off, move the data by hand
+            USART_IRQHandling(pUSARTInst);
+        }
+    }
+
+    // Wait for the shift register to empty, TXC0 is only meaningful once a byte was sent
+    if (pUSARTInst->TxRingActive)
+    {
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_TXC0)));
+        pUSARTInst->TxRingActive = 0;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_TxEnqueue
+ *
+ * @brief         - Queues a transmission behind the ones already pending.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pDesc: Descriptor of the data to send.
+ *
+ * @return        - USART_READY if queued, USART_BUSY_IN_TX if the queue is full.
+ *
+ * @Note          - Queued descriptors go out back to back with no gap between
+ *                  frames. The descriptor and its data belong to the driver until
+ *                  its pDone callback, which runs from the UDRE ISR when the last
+ *                  byte was loaded (it is still being shifted out). May be called
+ *                  from thread context and from pDone. The queue is served before
+ *                  the USART_Write ring, and after USART_SendDataIT transfers.
+ */
+uint8_t USART_TxEnqueue(USART_t *pUSARTInst, USART_TxDesc_t *pDesc)
+{
+    uint8_t head;
+    uint8_t sreg;
+
+    sreg = CPU_SREG_REG;
+    IRQ_DIS();
+
+    head = pUSARTInst->TxQHead;
+
+    if ((uint8_t)(head - pUSARTInst->TxQTail) >= USART_TX_QUEUE_SIZE)
+    {
+        CPU_SREG_REG = sreg;
+        return USART_BUSY_IN_TX;
+    }
+
+    pUSARTInst->TxQueue[head & USART_TX_QUEUE_MASK] = pDesc;
+    pUSARTInst->TxQHead = head + 1;
+
+    // Enable Data Register Empty interrupt (UDRIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+
+    CPU_SREG_REG = sreg;
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_TxQueueFree
+ *
+ * @brief         - Returns the number of free slots in the transmission queue.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - Number of descriptors that USART_TxEnqueue accepts right now.
+ *
+ * @Note          - None
+ */
+uint8_t USART_TxQueueFree(USART_t *pUSARTInst)
+{
+    return USART_TX_QUEUE_SIZE - (uint8_t)(pUSARTInst->TxQHead - pUSARTInst->TxQTail);
+}
+
+/*********************************************************************
+ * @fn            - USART_AutoBaud
+ *
+ * @brief         - Measures the baud rate of an incoming sync character and
+ *                  reprograms UBRR0/U2X0 to match it.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - Timeout: Maximum wait for the sync character in ms (0 = forever).
+ *
+ * @return        - USART_AUTOBAUD_OK, USART_AUTOBAUD_TIMEOUT or USART_AUTOBAUD_INVALID.
+ *
+ * @Note          - The peer sends USART_AUTOBAUD_SYNC (0x55, 8N1), whose rising
+ *                  edges are exactly two bits apart. The time from the first to the
+ *                  fifth rising edge (8 bit times) is measured on PD0 with Timer1 at
+ *                  F_CPU, the four 2-bit periods must agree within 1/16, and the
+ *                  normal or double speed divider with the lowest error is chosen
+ *                  (normal on ties, as USART_BAUD() does). The sync character is
+ *                  not delivered to the receiver.
+ *                  Timer1 is borrowed: its control and mask registers are restored,
+ *                  TCNT1 is not. Interrupts are disabled for the ten bit times of
+ *                  the measurement, which only stores the five edge timestamps.
+ *                  Call it with the transmitter idle. Each 2-bit period must fit
+ *                  in 16 bits, so the slowest rate is F_CPU / 32768 (488 baud at
+ *                  16 MHz). The edge poll loop sets the timing jitter. At the -O0
+ *                  build one poll is estimated at about 30 cycles (not measured).
+ *                  Two stamps can then differ by up to 60 cycles, and the check
+ *                  allows 1/8 bit, so the limit is about F_CPU / 480: 19200 baud
+ *                  at 16 MHz, with 38400 marginal. Faster rates return
+ *                  USART_AUTOBAUD_INVALID.
+ *                  On success Config.USART_Baud holds the new value.
+ */
+uint8_t USART_AutoBaud(USART_t *pUSARTInst, uint16_t Timeout)
+{
+    uint32_t limit = ((uint32_t)Timeout * (F_CPU / 1000UL) >> 16) + 1;
+    uint32_t period, total = 0;
+    uint32_t minPeriod = 0xFFFFFFFFUL, maxPeriod = 0;
+    uint32_t div16, div8, diff16, diff8, diff;
+    uint16_t stamp[5];
+    uint16_t ovf = 0;
+    uint16_t baud;
+    uint8_t result = USART_AUTOBAUD_OK;
+    uint8_t sreg;
+
+    // Borrow Timer1 as a free-running cycle counter
+    uint8_t tccr1a = TIM1->TCCR1A;
+    uint8_t tccr1b = TIM1->TCCR1B;
+    uint8_t timsk1 = TIM1_TIMSK1_REG;
+    uint8_t ucsr0b = pUSARTInst->pReg->UCSR0B;
+
+    TIM1_TIMSK1_REG = 0;
+    TIM1->TCCR1B = 0;
+    TIM1->TCCR1A = 0;
+    TIM1->TCNT1 = 0;
+    TIM1_TIFR1_REG = (1 << TIM1_TIFR1_TOV1);
+    TIM1->TCCR1B = (1 << TIM1_TCCR1B_CS10);
+
+    // Keep the receiver away from the sync character
+    pUSARTInst->pReg->UCSR0B = ucsr0b & ~(1 << USART_UCSR0B_RXEN0);
+
+    // Wait for an idle (high) line, then for the falling edge of the start bit
+    if (!usart_autobaud_wait(1, Timeout ? limit : 0, &ovf) ||
+        !usart_autobaud_wait(0, Timeout ? limit : 0, &ovf))
+    {
+        result = USART_AUTOBAUD_TIMEOUT;
+    }
+
+    if (result == USART_AUTOBAUD_OK)
+    {
+        sreg = CPU_SREG_REG;
+        IRQ_DIS();
+
+        // Rising edge at the end of the start bit, then the four of the data
+        // bits, two bit times apart. Only the raw timestamps are taken here.
+        for (uint8_t i = 0; (i < 5) && (result == USART_AUTOBAUD_OK); i++)
+        {
+            if (((i != 0) && !usart_autobaud_edge(0)) || !usart_autobaud_edge(1))
+                result = USART_AUTOBAUD_INVALID;
+            stamp[i] = TIM1->TCNT1;
+        }
+
+        CPU_SREG_REG = sreg;
+    }
+
+    if (result == USART_AUTOBAUD_OK)
+    {
+        // 16-bit differences, Timer1 wrapping between two edges is harmless
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            period = (uint16_t)(stamp[i + 1] - stamp[i]);
+            total += period;
+            if (period < minPeriod)
+                minPeriod = period;
+            if (period > maxPeriod)
+                maxPeriod = period;
+        }
+    }
+
+    // A different character gives unequal periods
+    if ((result == USART_AUTOBAUD_OK) && ((maxPeriod - minPeriod) > (total / 64)))
+    {
+        result = USART_AUTOBAUD_INVALID;
+    }
+
+    if (result == USART_AUTOBAUD_OK)
+    {
+        // total is 8 bit times: (UBRR0 + 1) * 16 * 8 normal, (UBRR0 + 1) * 8 * 8 double speed
+        div16 = (total + 64) / 128;
+        div8 = (total + 32) / 64;
+        diff16 = (total > div16 * 128) ? (total - div16 * 128) : (div16 * 128 - total);
+        diff8 = (total > div8 * 64) ? (total - div8 * 64) : (div8 * 64 - total);
+
+        if ((div16 >= 1) && (div16 <= (USART_BAUD_UBRR_MASK + 1UL)) && !((diff8 < diff16) && (div8 <= (USART_BAUD_UBRR_MASK + 1UL))))
+        {
+            baud = (uint16_t)(div16 - 1);
+            diff = diff16;
+        }
+        else if ((div8 >= 1) && (div8 <= (USART_BAUD_UBRR_MASK + 1UL)))
+        {
+            baud = (uint16_t)(div8 - 1) | USART_BAUD_U2X;
+            diff = diff8;
+        }
+        else
+        {
+            baud = 0;
+            diff = total;
+        }
+
+        if ((diff * 1000UL) > (total * USART_BAUD_MAX_ERR_PERMILLE))
+        {
+            // Too fast (or too slow) for any divider within tolerance
+            result = USART_AUTOBAUD_INVALID;
+        }
+        else
+        {
+            pUSARTInst->Config.USART_Baud = baud;
+            usart_baud_write(pUSARTInst->pReg, baud);
+
+            // The idle gap is measured in characters, follow the new rate
+            if (pUSARTInst->Config.USART_IdleTime != 0)
+            {
+                usart_idle_init(pUSARTInst);
+            }
+        }
+    }
+
+    // Give Timer1 and the receiver back
+    TIM1->TCCR1B = 0;
+    TIM1_TIFR1_REG = (1 << TIM1_TIFR1_TOV1);
+    TIM1->TCCR1A = tccr1a;
+    TIM1->TCCR1B = tccr1b;
+    TIM1_TIMSK1_REG = timsk1;
+    pUSARTInst->pReg->UCSR0B = ucsr0b;
+
+    return result;
+}
+
+/*********************************************************************
+ * @fn            - USART_RxRingControl
+ *
+ * @brief         - Arms or disarms continuous reception into the receive ring.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - EnOrDi: ENABLE or DISABLE macros.
+ *
+ * @return        - USART_READY, or the busy state when a USART_ReceiveDataIT
+ *                  or the byte stream owns the receiver (the ring is not armed).
+ *
+ * @Note          - While armed, RXCIE stays enabled and every received byte is
+ *                  pushed into the ring; bytes arriving with the ring full are dropped.
+ *                  USART_ReceiveDataIT is rejected until the ring is disarmed.
+ */
+uint8_t USART_RxRingControl(USART_t *pUSARTInst, uint8_t EnOrDi)
+{
+    uint8_t state;
+    uint8_t sreg = CPU_SREG_REG;
+    IRQ_DIS();
+
+    state = pUSARTInst->RxBusyState;
+
+    if (EnOrDi == ENABLE)
+    {
+        // A pending reception would never complete
+        if ((state != USART_READY) && (state != USART_BUSY_IN_RX_RING))
+        {
+            CPU_SREG_REG = sreg;
+            return state;
+        }
+
+        // Discard stale data and keep the RX Complete interrupt armed
+        pUSARTInst->RxTail = pUSARTInst->RxHead;
+        pUSARTInst->RxBusyState = USART_BUSY_IN_RX_RING;
+        pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+
+        // The ring is empty, let the peer send
+        if (pUSARTInst->Config.USART_FlowControl & USART_FLOW_RTS)
+        {
+            usart_rts_write(pUSARTInst, 0);
+        }
+    }
+    else if (pUSARTInst->RxBusyState == USART_BUSY_IN_RX_RING)
+    {
+        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_RXCIE0);
+        pUSARTInst->RxBusyState = USART_READY;
+    }
+
+    CPU_SREG_REG = sreg;
+
+    return USART_READY;
+}
+
+/*********************************************************************
+ * @fn            - USART_RxStreamControl
+ *
+ * @brief         - Hands every received byte to a handler from the RX ISR.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pHandler: Function called with each byte, or NULL to stop.
  *
  * @return        - None
  *
- * @Note          - Ensure that the USART clock is enabled before calling this function.
+ * @Note          - Used by protocol layers that decode incrementally (e.g. the
+ *                  packet layer). The handler runs in interrupt context. A layer
+ *                  keeps its state in pRxContext, set before this call, so each
+ *                  USART carries its own.
  */
-void USART_Init(USART_t *pUSARTInst)
+void USART_RxStreamControl(USART_t *pUSARTInst, USART_RxHandler_t pHandler)
 {
-    // Configure the USART mode (RX, TX, or RX/TX).
-    uint8_t ucsr0b = 0;
-    if (pUSARTInst->Config.USART_Mode != USART_MODE_ONLY_TX)
-        ucsr0b |= (1 << USART_UCSR0B_RXEN0);  // Enable RX if needed.
-    if (pUSARTInst->Config.USART_Mode != USART_MODE_ONLY_RX)
-        ucsr0b |= (1 << USART_UCSR0B_TXEN0);  // Enable TX if needed.
-    pUSARTInst->pReg->UCSR0B = ucsr0b;
+    uint8_t sreg = CPU_SREG_REG;
+    IRQ_DIS();
 
-    // Configure the USART word length (5, 6, 7, or 8 bits).
-    pUSARTInst->pReg->UCSR0C = (pUSARTInst->Config.USART_WordLength & 0x03) << USART_UCSR0C_UCSZ00;
+    if (pHandler != NULL)
+    {
+        // Keep the RX Complete interrupt armed and route bytes to the handler
+        pUSARTInst->pRxHandler = pHandler;
+        pUSARTInst->RxBusyState = USART_BUSY_IN_RX_STREAM;
+        pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+    }
+    else if (pUSARTInst->RxBusyState == USART_BUSY_IN_RX_STREAM)
+    {
+        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_RXCIE0);
+        pUSARTInst->RxBusyState = USART_READY;
+    }
 
-    // If 9 bits word length, set the UCSZ02 bit.
-    if (pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS)
-        pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UCSZ02);
-    else
-        pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_UCSZ02);
+    CPU_SREG_REG = sreg;
+}
 
-    // Configure the number of stop bits.
-    if (pUSARTInst->Config.USART_NoOfStopBits == USART_STOPBITS_2)
-        pUSARTInst->pReg->UCSR0C |= (1 << USART_UCSR0C_USBS0);
-    else
-        pUSARTInst->pReg->UCSR0C &= ~(1 << USART_UCSR0C_USBS0);
+/*********************************************************************
+ * @fn            - USART_Available
+ *
+ * @brief         - Returns the number of bytes waiting in the receive ring.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - Number of bytes that USART_Read can return right now.
+ *
+ * @Note          - None
+ */
+uint16_t USART_Available(USART_t *pUSARTInst)
+{
+    return (uint8_t)(pUSARTInst->RxHead - pUSARTInst->RxTail);
+}
 
-    // Configure the parity control (even/odd/no parity).
-    pUSARTInst->pReg->UCSR0C |= (pUSARTInst->Config.USART_ParityControl & 0x30) << USART_UCSR0C_UPM00;
+/*********************************************************************
+ * @fn            - USART_Read
+ *
+ * @brief         - Copies received bytes out of the receive ring without blocking.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[out]    - pRxBuffer: Pointer to the destination buffer.
+ * @param[in]     - Len: Maximum number of bytes to read.
+ *
+ * @return        - Number of bytes actually copied (0 if the ring is empty).
+ *
+ * @Note          - Single consumer only: call it from thread context.
+ */
+uint16_t USART_Read(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Len)
+{
+    uint8_t tail = pUSARTInst->RxTail;
 
-    // Configure the USART baud rate.
-    // The baud rate is calculated based on the system clock (16 MHz).
-    uint16_t baud = pUSARTInst->Config.USART_Baud;
-    pUSARTInst->pReg->UBRR0L = (uint8_t)(baud & 0x00FF);
-    pUSARTInst->pReg->UBRR0H = (uint8_t)((baud >> 8) & 0x0F);
+    // Clip the request to the data available in the ring
+    if (Len > USART_Available(pUSARTInst))
+    {
+        Len = USART_Available(pUSARTInst);
+    }
+
+    for (uint16_t i = 0; i < Len; i++)
+    {
+        pRxBuffer[i] = pUSARTInst->RxRing[tail & USART_RX_RING_MASK];
+        tail++;
+    }
+
+    usart_rx_release(pUSARTInst, tail);
+
+    return Len;
 }
 
+/*********************************************************************
+ * @fn            - USART_Peek
+ *
+ * @brief         - Returns the oldest byte in the receive ring without consuming it.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - The next byte (0-255), or -1 if the ring is empty.
+ *
+ * @Note          - None
+ */
+int16_t USART_Peek(USART_t *pUSARTInst)
+{
+    if (pUSARTInst->RxHead == pUSARTInst->RxTail)
+    {
+        return -1;
+    }
+
+    return pUSARTInst->RxRing[pUSARTInst->RxTail & USART_RX_RING_MASK];
+}
 
 /*********************************************************************
- * @fn            - USART_DeInit
+ * @fn            - USART_PeekAt
  *
- * @brief         - Deinitializes the USART peripheral and resets its registers.
+ * @brief         - Returns a byte of the receive ring without consuming it.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - Offset: Position counted from the oldest byte (0 = USART_Peek).
  *
- * @return        - None
+ * @return        - The byte (0-255), or -1 if fewer than Offset + 1 bytes are waiting.
  *
- * @Note          - This function resets the USART to its default state.
+ * @Note          - Lets parsers work on the data in place, see USART_Discard.
  */
-void USART_DeInit(USART_t *pUSARTInst)
+int16_t USART_PeekAt(USART_t *pUSARTInst, uint8_t Offset)
 {
-    // Reset all USART registers to zero
-    pUSARTInst->pReg->UCSR0B = 0x00;
-    pUSARTInst->pReg->UCSR0C = 0x00;
-    pUSARTInst->pReg->UBRR0L = 0x00;
-    pUSARTInst->pReg->UBRR0H = 0x00;
+    uint8_t tail = pUSARTInst->RxTail;
+
+    if (Offset >= (uint8_t)(pUSARTInst->RxHead - tail))
+    {
+        return -1;
+    }
+
+    return pUSARTInst->RxRing[(uint8_t)(tail + Offset) & USART_RX_RING_MASK];
 }
 
 /*********************************************************************
- * @fn            - USART_SendData
+ * @fn            - USART_Discard
  *
- * @brief         - Sends data via USART in blocking mode.
+ * @brief         - Drops bytes from the receive ring without copying them.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
- * @param[in]     - pTxBuffer: Pointer to the transmission buffer.
- * @param[in]     - Len: Length of the data to be sent.
+ * @param[in]     - Len: Maximum number of bytes to drop.
  *
- * @return        - None
+ * @return        - Number of bytes actually dropped.
  *
- * @Note          - Blocks until all data is sent.
+ * @Note          - Single consumer only: call it from thread context.
  */
-void USART_SendData(USART_t *pUSARTInst, uint8_t *pTxBuffer, uint32_t Len)
+uint16_t USART_Discard(USART_t *pUSARTInst, uint16_t Len)
 {
-    // Loop through the data to be sent
-    for(uint32_t i = 0; i < Len; i++)
+    if (Len > USART_Available(pUSARTInst))
     {
-        // Wait until the transmit buffer is ready for new data
-        while(!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+        Len = USART_Available(pUSARTInst);
+    }
 
-        // Handle 9-bit data transmission
-        if(pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS)
-        {
-            // Set TXB80 bit based on the 9th data bit (MSB)
-            pUSARTInst->pReg->UCSR0B = (pUSARTInst->pReg->UCSR0B & ~(1 << USART_UCSR0B_TXB80)) |
-                                       ((*pTxBuffer & 0x0100) >> 8); // TXB80 is the MSB of the data
-        }
+    usart_rx_release(pUSARTInst, pUSARTInst->RxTail + (uint8_t)Len);
 
-        // Transmit the lower 8 bits of the data
-        pUSARTInst->pReg->UDR0 = (uint8_t)(*pTxBuffer & 0xFF);
+    return Len;
+}
 
-        // Move to the next byte in the buffer
-        pTxBuffer++;
-    }
+/*********************************************************************
+ * @fn            - USART_SendAddress
+ *
+ * @brief         - Sends an address frame (9th bit set) on a multi-drop bus.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - Address: Address of the node to select.
+ *
+ * @return        - None
+ *
+ * @Note          - Blocks until the frame is moved to the shift register, then
+ *                  clears TXB80 so the following bytes go out as data frames.
+ *                  TXB80 is changed with interrupts disabled, the ISRs share UCSR0B.
+ *                  Do not call it while an interrupt-driven transmission is active.
+ */
+void USART_SendAddress(USART_t *pUSARTInst, uint8_t Address)
+{
+    // Wait until the transmit buffer is ready for new data
+    while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+
+    // Address frame: ninth bit set
+    usart_put9(pUSARTInst->pReg, 0x0100 | Address);
+
+    // Back to data frames once the address left the buffer
+    usart_tx9_end(pUSARTInst->pReg);
 }
 
 /*********************************************************************
- * @fn            - USART_ReceiveData
+ * @fn            - USART_SpiTransfer
  *
- * @brief         - Receives data via USART in blocking mode.
+ * @brief         - Exchanges data in Master SPI mode, blocking.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
- * @param[in]     - pRxBuffer: Pointer to the reception buffer.
- * @param[in]     - Len: Length of the data to be received.
+ * @param[in]     - pTxBuffer: Data to send, or NULL to clock out 0xFF.
+ * @param[out]    - pRxBuffer: Where to store received data, or NULL to discard it.
+ * @param[in]     - Len: Number of bytes to exchange.
  *
  * @return        - None
  *
- * @Note          - Blocks until all data is received.
+ * @Note          - The next byte is written while the current one shifts out,
+ *                  so consecutive bytes go out without a gap. At most two
+ *                  bytes are in flight to keep the receiver from overrunning.
+ *                  Chip select is handled by the application.
  */
-void USART_ReceiveData(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint32_t Len)
+void USART_SpiTransfer(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len)
 {
-    // Loop through the length of data to be received
-    for (uint32_t i = 0; i < Len; i++)
-    {
-        // Wait until there is data in the receive buffer
-        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_RXC0)));
+    uint16_t sent = 0;
+    uint16_t rcvd = 0;
 
-        // Handle 9-bit data reception
-        if (pUSARTInst->Config.USART_WordLength == USART_WORDLEN_9BITS)
+    while (rcvd < Len)
+    {
+        // Keep the transmit buffer loaded
+        if ((sent < Len) && ((uint16_t)(sent - rcvd) < 2) &&
+            (pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)))
         {
-            // Read the 9th bit from the RXB80 register
-            uint8_t ninthBit = (pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_RXB80)) << 7;
-
-            // Read the lower 8 bits from the UDR0 register
-            *pRxBuffer = (ninthBit | pUSARTInst->pReg->UDR0) & 0x01FF;
+            pUSARTInst->pReg->UDR0 = (pTxBuffer != NULL) ? pTxBuffer[sent] : 0xFF;
+            sent++;
         }
-        else
+
+        // Collect the bytes clocked in
+        if (pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_RXC0))
         {
-            // Read the received data (8 bits)
-            *pRxBuffer = pUSARTInst->pReg->UDR0;
+            uint8_t data = pUSARTInst->pReg->UDR0;
+            if (pRxBuffer != NULL)
+            {
+                pRxBuffer[rcvd] = data;
+            }
+            rcvd++;
         }
-
-        // Move to the next byte in the buffer
-        pRxBuffer++;
     }
 }
 
 /*********************************************************************
- * @fn            - USART_SendDataIT
+ * @fn            - USART_SpiTransferIT
  *
- * @brief         - Sends data via USART in interrupt mode.
+ * @brief         - Exchanges data in Master SPI mode using the RX Complete interrupt.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
- * @param[in]     - pTxBuffer: Pointer to the transmission buffer.
- * @param[in]     - Len: Length of the data to be sent.
+ * @param[in]     - pTxBuffer: Data to send, or NULL to clock out 0xFF.
+ * @param[out]    - pRxBuffer: Where to store received data, or NULL to discard it.
+ * @param[in]     - Len: Number of bytes to exchange.
  *
- * @return        - USART_BUSY_IN_TX if transmission is ongoing, USART_READY otherwise.
+ * @return        - USART_BUSY_IN_TX if a transfer is ongoing, USART_READY otherwise.
  *
- * @Note          - This function uses interrupts for data transmission.
+ * @Note          - USART_EVENT_SPI_CMPLT is raised when the last byte is received.
+ *                  USART_IRQHandling must be called from ISR_USART_RX.
  */
-uint8_t USART_SendDataIT(USART_t *pUSARTInst, uint8_t *pTxBuffer, uint32_t Len)
+uint8_t USART_SpiTransferIT(USART_t *pUSARTInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len)
 {
-    if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+    if ((pUSARTInst->TxBusyState != USART_READY) || (pUSARTInst->RxBusyState != USART_READY))
     {
         return USART_BUSY_IN_TX;
     }
 
-    // Save transmission details
+    if (Len == 0)
+    {
+        return USART_READY;
+    }
+
+    // Save transfer details
     pUSARTInst->pTxBuffer = pTxBuffer;
+    pUSARTInst->pRxBuffer = pRxBuffer;
     pUSARTInst->TxLen = Len;
+    pUSARTInst->RxLen = Len;
     pUSARTInst->TxBusyState = USART_BUSY_IN_TX;
+    pUSARTInst->RxBusyState = USART_BUSY_IN_RX;
 
-    // Enable Data Register Empty interrupt (UDRIE)
-    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    // Prime up to two bytes, the RXC interrupt keeps the pipeline full
+    for (uint8_t i = 0; (i < 2) && (pUSARTInst->TxLen > 0); i++)
+    {
+        while (!(pUSARTInst->pReg->UCSR0A & (1 << USART_UCSR0A_UDRE0)));
+        pUSARTInst->pReg->UDR0 = (pTxBuffer != NULL) ? *(pUSARTInst->pTxBuffer++) : 0xFF;
+        pUSARTInst->TxLen--;
+    }
+
+    // Enable RX Complete interrupt (RXCIE)
+    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
 
     return USART_READY;
 }
 
 /*********************************************************************
- * @fn            - USART_ReceiveDataIT
+ * @fn            - USART_GetStats
  *
- * @brief         - Receives data via USART in interrupt mode.
+ * @brief         - Takes a consistent snapshot of the receive error counters.
  *
  * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
- * @param[in]     - pRxBuffer: Pointer to the reception buffer.
- * @param[in]     - Len: Length of the data to be received.
+ * @param[out]    - pStats: Where to copy the counters.
  *
- * @return        - USART_BUSY_IN_RX if reception is ongoing, USART_READY otherwise.
+ * @return        - None
  *
- * @Note          - This function uses interrupts for data reception.
+ * @Note          - Interrupts are held off during the copy so all counters
+ *                  belong to the same instant.
  */
-uint8_t USART_ReceiveDataIT(USART_t *pUSARTInst, uint8_t *pRxBuffer, uint32_t Len)
+void USART_GetStats(USART_t *pUSARTInst, USART_Stats_t *pStats)
 {
-    if (pUSARTInst->RxBusyState == USART_BUSY_IN_RX)
-    {
-        return USART_BUSY_IN_RX;
-    }
-
-    // Save reception details
-    pUSARTInst->pRxBuffer = pRxBuffer;
-    pUSARTInst->RxLen = Len;
-    pUSARTInst->RxBusyState = USART_BUSY_IN_RX;
-
-    // Enable RX Complete interrupt (RXCIE)
-    pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_RXCIE0);
+    uint8_t sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    *pStats = pUSARTInst->Stats;
+    CPU_SREG_REG = sreg;
+}
 
-    return USART_READY;
+/*********************************************************************
+ * @fn            - USART_ClearStats
+ *
+ * @brief         - Resets the receive error counters.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - None
+ */
+void USART_ClearStats(USART_t *pUSARTInst)
+{
+    uint8_t sreg = CPU_SREG_REG;
+    IRQ_DIS();
+    pUSARTInst->Stats.FrameErrors = 0;
+    pUSARTInst->Stats.OverrunErrors = 0;
+    pUSARTInst->Stats.ParityErrors = 0;
+    pUSARTInst->Stats.RxDropped = 0;
+    CPU_SREG_REG = sreg;
 }
 
 /*********************************************************************
@@ -246,19 +1976,71 @@ void USART_IRQHandling(USART_t *pUSARTInst)
     // Handle Data Register Empty interrupt
     if ((status & (1 << USART_UCSR0A_UDRE0)) && (pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_UDRIE0)))
     {
-        if (pUSARTInst->TxLen > 0)
+        if (usart_cts_blocked(pUSARTInst))
+        {
+            // Peer not ready, USART_CtsIRQHandling resumes when CTS goes low
+            pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_UDRIE0);
+        }
+        else if (pUSARTInst->TxBusyState == USART_BUSY_IN_TX)
+        {
+            // Move on to the next non-empty segment of a vectored transmission
+            while ((pUSARTInst->TxLen == 0) && (pUSARTInst->TxSegCnt > 0))
+            {
+                pUSARTInst->pTxBuffer = pUSARTInst->pTxSeg->pData;
+                pUSARTInst->TxLen = pUSARTInst->pTxSeg->Len;
+                pUSARTInst->pTxSeg++;
+                pUSARTInst->TxSegCnt--;
+            }
+
+            if ((pUSARTInst->TxLen > 0) && pUSARTInst->TxWord9)
+            {
+                // Send the next 9-bit word
+                usart_put9(pUSARTInst->pReg, usart_word9_fetch(pUSARTInst));
+                pUSARTInst->TxLen--;
+            }
+            else if (pUSARTInst->TxLen > 0)
+            {
+                // Send the next byte
+                pUSARTInst->pReg->UDR0 = *(pUSARTInst->pTxBuffer++);
+                pUSARTInst->TxLen--;
+            }
+            else
+            {
+                // Transmission complete, disable UDRIE
+                pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_UDRIE0);
+
+                // The last word left UDR0: following bytes go out as data frames
+                if (pUSARTInst->TxWord9)
+                {
+                    pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_TXB80);
+                    pUSARTInst->TxWord9 = USART_WORD9_NONE;
+                }
+
+                // Enable TX Complete interrupt (TXCIE)
+                pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_TXCIE0);
+            }
+        }
+        else if (pUSARTInst->TxQHead != pUSARTInst->TxQTail)
+        {
+            // Queued descriptors, chained without waiting for TXC
+            usart_txq_handle(pUSARTInst);
+        }
+        else if (pUSARTInst->TxHead != pUSARTInst->TxTail)
         {
-            // Send the next byte
-            pUSARTInst->pReg->UDR0 = *(pUSARTInst->pTxBuffer++);
-            pUSARTInst->TxLen--;
+            // Drain the next byte from the transmit ring
+            uint8_t tail = pUSARTInst->TxTail;
+            pUSARTInst->pReg->UDR0 = pUSARTInst->TxRing[tail & USART_TX_RING_MASK];
+            pUSARTInst->TxTail = tail + 1;
+
+            // Clear TXC0 (write one) so USART_Flush can tell when this byte left the wire
+            pUSARTInst->pReg->UCSR0A = (pUSARTInst->pReg->UCSR0A & ((1 << USART_UCSR0A_U2X0) | (1 << USART_UCSR0A_MPCM0))) |
+                                       (1 << USART_UCSR0A_TXC0);
+            pUSARTInst->TxRingActive = 1;
         }
         else
         {
-            // Transmission complete, disable UDRIE
+            // Ring empty, disable UDRIE until USART_Write queues more data
             pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_UDRIE0);
-
-            // Enable TX Complete interrupt (TXCIE)
-            pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_TXCIE0);
         }
     }
 
@@ -269,6 +2051,12 @@ void USART_IRQHandling(USART_t *pUSARTInst)
         pUSARTInst->pReg->UCSR0B &= ~(1 << USART_UCSR0B_TXCIE0);
         pUSARTInst->TxBusyState = USART_READY;
 
+        // Resume draining the transmit ring or queue if data was queued meanwhile
+        if ((pUSARTInst->TxHead != pUSARTInst->TxTail) || (pUSARTInst->TxQHead != pUSARTInst->TxQTail))
+        {
+            pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+        }
+
         // Notify application of TX complete
         USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_TX_CMPLT);
     }
@@ -276,10 +2064,79 @@ void USART_IRQHandling(USART_t *pUSARTInst)
     // Handle RX Complete interrupt
     if ((status & (1 << USART_UCSR0A_RXC0)) && (pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_RXCIE0)))
     {
-        if (pUSARTInst->RxLen > 0)
+        // RXB80 must be read before UDR0; reading UDR0 also clears RXC
+        uint8_t rxb8 = pUSARTInst->pReg->UCSR0B & (1 << USART_UCSR0B_RXB80);
+        uint8_t data = pUSARTInst->pReg->UDR0;
+
+        // Error flags were captured in status before UDR0 was read
+        if (status & ((1 << USART_UCSR0A_FE0) | (1 << USART_UCSR0A_DOR0) | (1 << USART_UCSR0A_UPE0)))
+        {
+            usart_rx_error_handle(pUSARTInst, status);
+        }
+
+        // Every received frame restarts the idle-line gap
+        if (pUSARTInst->Config.USART_IdleTime != 0)
+        {
+            usart_idle_restart();
+        }
+
+        if (pUSARTInst->Config.USART_Mode == USART_MODE_MSPIM)
+        {
+            // Master SPI transfer in progress
+            usart_mspim_rxc_handle(pUSARTInst, data);
+        }
+        else if ((pUSARTInst->Config.USART_MPCM == ENABLE) && rxb8)
+        {
+            // Address frame: only wake up for frames addressed to this node
+            if (data == pUSARTInst->Config.USART_OwnAddress)
+            {
+                usart_mpcm_control(pUSARTInst->pReg, DISABLE);
+                USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_ADDR_MATCH);
+            }
+            else
+            {
+                usart_mpcm_control(pUSARTInst->pReg, ENABLE);
+            }
+        }
+        else if (pUSARTInst->RxBusyState == USART_BUSY_IN_RX_STREAM)
+        {
+            // Let the protocol layer decode the byte right away
+            pUSARTInst->pRxHandler(pUSARTInst, data);
+        }
+        else if (pUSARTInst->RxBusyState == USART_BUSY_IN_RX_RING)
+        {
+            // Push the byte if there is room, otherwise drop it
+            uint8_t head = pUSARTInst->RxHead;
+
+            if ((uint8_t)(head - pUSARTInst->RxTail) < USART_RX_RING_SIZE)
+            {
+                pUSARTInst->RxRing[head & USART_RX_RING_MASK] = data;
+                pUSARTInst->RxHead = head + 1;
+
+                // Hold the peer off before the ring overflows
+                if ((pUSARTInst->Config.USART_FlowControl & USART_FLOW_RTS) &&
+                    ((uint8_t)(head + 1 - pUSARTInst->RxTail) >= USART_RTS_HIGH_WATER))
+                {
+                    usart_rts_write(pUSARTInst, 1);
+                }
+            }
+            else
+            {
+                usart_stat_inc(&pUSARTInst->Stats.RxDropped);
+            }
+        }
+        else if (pUSARTInst->RxLen > 0)
         {
-            // Read the received byte
-            *(pUSARTInst->pRxBuffer++) = pUSARTInst->pReg->UDR0;
+            if (pUSARTInst->RxWord9)
+            {
+                // Store the received 9-bit word
+                usart_word9_store(pUSARTInst, rxb8, data);
+            }
+            else
+            {
+                // Store the received byte
+                *(pUSARTInst->pRxBuffer++) = data;
+            }
             pUSARTInst->RxLen--;
 
             if (pUSARTInst->RxLen == 0)
@@ -295,6 +2152,63 @@ void USART_IRQHandling(USART_t *pUSARTInst)
     }
 }
 
+/*********************************************************************
+ * @fn            - USART_IdleIRQHandling
+ *
+ * @brief         - Handles the Timer2 compare match that ends an idle gap.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - Call it from ISR(ISR_TIMER2_COMPA). The event fires once per
+ *                  gap; the next received frame re-arms it. The bytes of the
+ *                  frame are already waiting in the RX ring (USART_Available).
+ */
+void USART_IdleIRQHandling(USART_t *pUSARTInst)
+{
+    // One-shot: stay quiet until the line becomes active again
+    TIM2_TIMSK2_REG &= ~(1 << TIM2_TIMSK2_OCIE2A);
+
+    // Notify application of the end of the frame
+    USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_IDLE);
+}
+
+/*********************************************************************
+ * @fn            - USART_CtsIRQHandling
+ *
+ * @brief         - Handles a change of the CTS line.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - Call it from the INT/PCINT vector of USART_CtsPin. Other pins
+ *                  sharing a PCINT vector are ignored, USART_EVENT_CTS is only
+ *                  raised when the CTS level really changed.
+ */
+void USART_CtsIRQHandling(USART_t *pUSARTInst)
+{
+    uint8_t level = usart_cts_blocked(pUSARTInst);
+
+    if (level == pUSARTInst->CtsLevel)
+    {
+        return;
+    }
+    pUSARTInst->CtsLevel = level;
+
+    // CTS asserted again: resume whatever transmission was paused
+    if (!level && ((pUSARTInst->TxBusyState == USART_BUSY_IN_TX) ||
+                   (pUSARTInst->TxQHead != pUSARTInst->TxQTail) ||
+                   (pUSARTInst->TxHead != pUSARTInst->TxTail)))
+    {
+        pUSARTInst->pReg->UCSR0B |= (1 << USART_UCSR0B_UDRIE0);
+    }
+
+    // Notify application of the CTS change
+    USART_ApplicationEventCallback(pUSARTInst, USART_EVENT_CTS);
+}
+
 /*********************************************************************
  * @fn            - USART_PeripheralControl
  *
@@ -0,0 +1,477 @@
+/*
+ * @file              atmega328p_usart_cli.c
+ *
+ * @brief             Command interpreter for the ATmega328P USART driver.
+ *
+ * @details           Works directly on the USART receive ring (USART_RxRingControl).
+ *                    USART_CliProcess looks for the end of a line with USART_PeekAt,
+ *                    splits it into tokens recorded as ring offsets, finds the command
+ *                    with a binary search over a sorted table in flash and calls its
+ *                    handler. The line is released with USART_Discard afterwards, so
+ *                    the received bytes are never copied.
+ *
+ * @note              Lines end with CR or LF (CR LF gives one empty line, which is
+ *                    ignored). Tokens are separated by spaces or tabs.
+ */
+
+#include "atmega328p_usart_cli.h"
+
+/*********************************************************************
+ * @fn            - cli_char
+ *
+ * @brief         - Reads the byte at a ring offset of the current line.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Offset: Offset from the oldest byte of the receive ring.
+ *
+ * @return        - The byte.
+ *
+ * @Note          - Only called for offsets inside the line, which are present.
+ */
+static uint8_t cli_char(USART_Cli_t *pCliInst, uint8_t Offset)
+{
+    return (uint8_t)USART_PeekAt(pCliInst->pUSART, Offset);
+}
+
+/*********************************************************************
+ * @fn            - cli_compare
+ *
+ * @brief         - Compares a token with a string in flash.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index.
+ * @param[in]     - pStr_P: NUL terminated string in flash.
+ *
+ * @return        - <0, 0 or >0 as strcmp(token, string).
+ *
+ * @Note          - None
+ */
+static int8_t cli_compare(USART_Cli_t *pCliInst, uint8_t Index, const char *pStr_P)
+{
+    uint8_t off = pCliInst->ArgOff[Index];
+    uint8_t len = pCliInst->ArgLen[Index];
+
+    for (uint8_t i = 0; ; i++)
+    {
+        uint8_t n = pgm_read_byte(pStr_P + i);
+
+        if (i == len)
+            return n ? -1 : 0;
+
+        uint8_t c = cli_char(pCliInst, off + i);
+
+        if (c != n)
+            return (c < n) ? -1 : 1;
+    }
+}
+
+/*********************************************************************
+ * @fn            - cli_name
+ *
+ * @brief         - Reads the name pointer of a command table entry.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - i: Entry index.
+ *
+ * @return        - Name, in flash.
+ *
+ * @Note          - None
+ */
+static const char *cli_name(USART_Cli_t *pCliInst, uint8_t i)
+{
+    return (const char *)(uintptr_t)pgm_read_word(&pCliInst->pCmdTable[i].pName);
+}
+
+/*********************************************************************
+ * @fn            - cli_parse_u32
+ *
+ * @brief         - Parses decimal or 0x prefixed hexadecimal digits of the line.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - off: Offset of the first digit.
+ * @param[in]     - len: Number of characters.
+ * @param[out]    - pValue: Parsed value.
+ *
+ * @return        - 1 on success, 0 on an empty, invalid or out of range number.
+ *
+ * @Note          - None
+ */
+static uint8_t cli_parse_u32(USART_Cli_t *pCliInst, uint8_t off, uint8_t len, uint32_t *pValue)
+{
+    uint32_t value = 0;
+    uint8_t base = 10;
+
+    if ((len > 2) && (cli_char(pCliInst, off) == '0') && ((cli_char(pCliInst, off + 1) | 0x20) == 'x'))
+    {
+        base = 16;
+        off += 2;
+        len -= 2;
+    }
+
+    if (len == 0)
+        return 0;
+
+    while (len--)
+    {
+        uint8_t c = cli_char(pCliInst, off++);
+        uint8_t digit;
+
+        if ((c >= '0') && (c <= '9'))
+            digit = c - '0';
+        else if ((base == 16) && ((c | 0x20) >= 'a') && ((c | 0x20) <= 'f'))
+            digit = (c | 0x20) - 'a' + 10;
+        else
+            return 0;
+
+        if (value > (0xFFFFFFFFUL - digit) / base)
+            return 0;
+
+        value = value * base + digit;
+    }
+
+    *pValue = value;
+    return 1;
+}
+
+/*********************************************************************
+ * @fn            - cli_execute
+ *
+ * @brief         - Tokenizes a complete line and runs its command.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - len: Length of the line, without its terminator.
+ *
+ * @return        - None
+ *
+ * @Note          - The line starts at the oldest byte of the receive ring.
+ */
+static void cli_execute(USART_Cli_t *pCliInst, uint8_t len)
+{
+    uint8_t argc = 0;
+    uint8_t off = 0;
+
+    while (1)
+    {
+        // Skip separators
+        while ((off < len) && ((cli_char(pCliInst, off) == ' ') || (cli_char(pCliInst, off) == '\t')))
+            off++;
+
+        if (off == len)
+            break;
+
+        if (argc == USART_CLI_MAX_ARGS)
+        {
+            USART_CliEventCallback(pCliInst, USART_CLI_EVENT_TOO_MANY);
+            return;
+        }
+
+        pCliInst->ArgOff[argc] = off;
+        while ((off < len) && (cli_char(pCliInst, off) != ' ') && (cli_char(pCliInst, off) != '\t'))
+            off++;
+        pCliInst->ArgLen[argc] = off - pCliInst->ArgOff[argc];
+        argc++;
+    }
+
+    // Empty line
+    if (argc == 0)
+        return;
+
+    pCliInst->Argc = argc;
+
+    // Binary search, the table is sorted by name
+    uint8_t lo = 0;
+    uint8_t hi = pCliInst->NoOfCmds;
+
+    while (lo < hi)
+    {
+        uint8_t mid = (uint8_t)((lo + hi) / 2);
+        int8_t r = cli_compare(pCliInst, 0, cli_name(pCliInst, mid));
+
+        if (r == 0)
+        {
+            void (*pHandler)(USART_Cli_t *, uint8_t) =
+                (void (*)(USART_Cli_t *, uint8_t))(uintptr_t)pgm_read_word(&pCliInst->pCmdTable[mid].pHandler);
+
+            pHandler(pCliInst, argc);
+            return;
+        }
+
+        if (r < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    USART_CliEventCallback(pCliInst, USART_CLI_EVENT_UNKNOWN);
+}
+
+/*********************************************************************
+ * @fn            - USART_CliInit
+ *
+ * @brief         - Attaches a command table to a USART and arms its receive ring.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - pUSARTInst: Pointer to an initialized USART handle.
+ * @param[in]     - pCmdTable: Command table in flash, sorted by name.
+ * @param[in]     - NoOfCmds: Number of entries in pCmdTable.
+ *
+ * @return        - USART_CLI_OK, USART_CLI_ERR_UNSORTED if the binary search
+ *                  would miss commands, or USART_CLI_ERR_BUSY if a reception
+ *                  owns the receiver (the interpreter is not started).
+ *
+ * @Note          - None
+ */
+uint8_t USART_CliInit(USART_Cli_t *pCliInst, USART_t *pUSARTInst, const USART_CliCmd_t *pCmdTable, uint8_t NoOfCmds)
+{
+    pCliInst->pUSART = pUSARTInst;
+    pCliInst->pCmdTable = pCmdTable;
+    pCliInst->NoOfCmds = NoOfCmds;
+    pCliInst->ScanOff = 0;
+    pCliInst->Skip = 0;
+    pCliInst->Argc = 0;
+
+    // Each name must sort strictly after the previous one
+    for (uint8_t i = 1; i < NoOfCmds; i++)
+    {
+        const char *pPrev = cli_name(pCliInst, i - 1);
+        const char *pName = cli_name(pCliInst, i);
+        uint8_t a, b;
+
+        do
+        {
+            a = pgm_read_byte(pPrev++);
+            b = pgm_read_byte(pName++);
+        } while ((a == b) && (a != '\0'));
+
+        if (a >= b)
+            return USART_CLI_ERR_UNSORTED;
+    }
+
+    if (USART_RxRingControl(pUSARTInst, ENABLE) != USART_READY)
+        return USART_CLI_ERR_BUSY;
+
+    return USART_CLI_OK;
+}
+
+/*********************************************************************
+ * @fn            - USART_CliProcess
+ *
+ * @brief         - Runs the commands of every complete line received so far.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ *
+ * @return        - None
+ *
+ * @Note          - Call it from the main loop. Handlers run from here, in thread
+ *                  context. Each received byte is examined once while waiting for
+ *                  the end of its line.
+ */
+void USART_CliProcess(USART_Cli_t *pCliInst)
+{
+    USART_t *pUSARTInst = pCliInst->pUSART;
+    int16_t c;
+
+    // With RTS flow control the ring stops filling at the high watermark
+    uint8_t limit = (pUSARTInst->Config.USART_FlowControl & USART_FLOW_RTS) ?
+                    USART_RTS_HIGH_WATER : USART_RX_RING_SIZE;
+
+    while ((c = USART_PeekAt(pUSARTInst, pCliInst->ScanOff)) >= 0)
+    {
+        if ((c == '\r') || (c == '\n'))
+        {
+            if (pCliInst->Skip)
+                pCliInst->Skip = 0;
+            else
+                cli_execute(pCliInst, pCliInst->ScanOff);
+
+            // Release the line and its terminator
+            USART_Discard(pUSARTInst, (uint16_t)pCliInst->ScanOff + 1);
+            pCliInst->ScanOff = 0;
+        }
+        else
+        {
+            pCliInst->ScanOff++;
+        }
+    }
+
+    // A line that cannot fit is dropped up to its end of line
+    if (pCliInst->ScanOff >= limit)
+    {
+        USART_Discard(pUSARTInst, pCliInst->ScanOff);
+        pCliInst->ScanOff = 0;
+
+        if (!pCliInst->Skip)
+        {
+            pCliInst->Skip = 1;
+            USART_CliEventCallback(pCliInst, USART_CLI_EVENT_OVERFLOW);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_CliArgLen
+ *
+ * @brief         - Returns the length of a token.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index (0 is the command name).
+ *
+ * @return        - Length in bytes, 0 if there is no such token.
+ *
+ * @Note          - None
+ */
+uint8_t USART_CliArgLen(USART_Cli_t *pCliInst, uint8_t Index)
+{
+    return (Index < pCliInst->Argc) ? pCliInst->ArgLen[Index] : 0;
+}
+
+/*********************************************************************
+ * @fn            - USART_CliArgIs
+ *
+ * @brief         - Checks whether a token equals a keyword.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index.
+ * @param[in]     - pStr_P: Keyword in flash, e.g. PSTR("on").
+ *
+ * @return        - 1 if equal, 0 otherwise or if there is no such token.
+ *
+ * @Note          - None
+ */
+uint8_t USART_CliArgIs(USART_Cli_t *pCliInst, uint8_t Index, const char *pStr_P)
+{
+    return (Index < pCliInst->Argc) && (cli_compare(pCliInst, Index, pStr_P) == 0);
+}
+
+/*********************************************************************
+ * @fn            - USART_CliArgU32
+ *
+ * @brief         - Parses a token as an unsigned number.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index.
+ * @param[out]    - pValue: Parsed value, untouched on failure.
+ *
+ * @return        - 1 on success, 0 if missing, not a number or above 0xFFFFFFFF.
+ *
+ * @Note          - Decimal, or hexadecimal with a 0x prefix.
+ */
+uint8_t USART_CliArgU32(USART_Cli_t *pCliInst, uint8_t Index, uint32_t *pValue)
+{
+    if (Index >= pCliInst->Argc)
+        return 0;
+
+    return cli_parse_u32(pCliInst, pCliInst->ArgOff[Index], pCliInst->ArgLen[Index], pValue);
+}
+
+/*********************************************************************
+ * @fn            - USART_CliArgI32
+ *
+ * @brief         - Parses a token as a signed number.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index.
+ * @param[out]    - pValue: Parsed value, untouched on failure.
+ *
+ * @return        - 1 on success, 0 if missing, not a number or out of range.
+ *
+ * @Note          - Optional sign, then the formats of USART_CliArgU32.
+ */
+uint8_t USART_CliArgI32(USART_Cli_t *pCliInst, uint8_t Index, int32_t *pValue)
+{
+    uint32_t value;
+    uint8_t off, len;
+    uint8_t neg = 0;
+
+    if (Index >= pCliInst->Argc)
+        return 0;
+
+    off = pCliInst->ArgOff[Index];
+    len = pCliInst->ArgLen[Index];
+
+    if ((cli_char(pCliInst, off) == '-') || (cli_char(pCliInst, off) == '+'))
+    {
+        neg = (cli_char(pCliInst, off) == '-');
+        off++;
+        len--;
+    }
+
+    if (!cli_parse_u32(pCliInst, off, len, &value) || (value > (neg ? 0x80000000UL : 0x7FFFFFFFUL)))
+        return 0;
+
+    *pValue = neg ? (int32_t)(0 - value) : (int32_t)value;
+    return 1;
+}
+
+/*********************************************************************
+ * @fn            - USART_CliArgCopy
+ *
+ * @brief         - Copies a token out of the ring as a C string.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Index: Token index.
+ * @param[out]    - pBuffer: Destination, always NUL terminated.
+ * @param[in]     - Size: Size of pBuffer (at least 1).
+ *
+ * @return        - 1 if the whole token fitted, 0 if it was truncated or missing.
+ *
+ * @Note          - For handlers that need the text after returning; everything
+ *                  else can be done in place with the other parsers.
+ */
+uint8_t USART_CliArgCopy(USART_Cli_t *pCliInst, uint8_t Index, char *pBuffer, uint8_t Size)
+{
+    uint8_t len = USART_CliArgLen(pCliInst, Index);
+    uint8_t n = (len < Size) ? len : (uint8_t)(Size - 1);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        pBuffer[i] = (char)cli_char(pCliInst, pCliInst->ArgOff[Index] + i);
+    }
+    pBuffer[n] = '\0';
+
+    return (Index < pCliInst->Argc) && (n == len);
+}
+
+/*********************************************************************
+ * @fn            - USART_CliEventCallback
+ *
+ * @brief         - Weak implementation of the interpreter event callback.
+ *
+ * @param[in]     - pCliInst: Pointer to the interpreter handle.
+ * @param[in]     - Event: USART_CLI_EVENT_x.
+ *
+ * @return        - None
+ *
+ * @Note          - Runs in thread context, from USART_CliProcess. The tokens of
+ *                  the offending line are still available for USART_CLI_EVENT_UNKNOWN.
+ */
+__attribute__((weak)) void USART_CliEventCallback(USART_Cli_t *pCliInst, uint8_t Event)
+{
+    // Implementation here
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -0,0 +1,359 @@
+/*
+ * @file              atmega328p_usart_pkt.c
+ *
+ * @brief             COBS/CRC-16 packet layer for the ATmega328P USART driver.
+ *
+ * @details           Each packet is the payload followed by its CRC-16/CCITT (big endian),
+ *                    COBS encoded and terminated by a 0x00 delimiter. The transmitter
+ *                    encodes block by block into the USART transmit ring (USART_Write),
+ *                    the receiver decodes and checks the CRC incrementally in the RX ISR
+ *                    through USART_RxStreamControl. Only packets with a valid CRC reach
+ *                    USART_PktReceivedCallback.
+ *
+ * @note              Only one packet channel can receive at a time.
+ */
+
+#include <avr/pgmspace.h>
+#include "atmega328p_usart_pkt.h"
+
+/*
+ * CRC-16/CCITT lookup table (poly 0x1021), kept in flash
+ */
+static const uint16_t crc16_table[256] PROGMEM = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+/*********************************************************************
+ * @fn            - pkt_crc16_update
+ *
+ * @brief         - Adds one byte to a running CRC-16/CCITT.
+ *
+ * @param[in]     - Crc: Current CRC value.
+ * @param[in]     - Data: Byte to add.
+ *
+ * @return        - Updated CRC value.
+ *
+ * @Note          - One table lookup per byte, cheap enough for the RX ISR.
+ */
+static inline uint16_t pkt_crc16_update(uint16_t Crc, uint8_t Data)
+{
+    return (Crc << 8) ^ pgm_read_word(&crc16_table[(uint8_t)(Crc >> 8) ^ Data]);
+}
+
+/*********************************************************************
+ * @fn            - pkt_write
+ *
+ * @brief         - Queues bytes in the USART transmit ring.
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - pData: Bytes to queue.
+ * @param[in]     - Len: Number of bytes.
+ *
+ * @return        - None
+ *
+ * @Note          - Waits only while the transmit ring is full.
+ */
+static void pkt_write(USART_t *pUSARTInst, const uint8_t *pData, uint16_t Len)
+{
+    while (Len > 0)
+    {
+        uint16_t done = USART_Write(pUSARTInst, pData, Len);
+        pData += done;
+        Len -= done;
+    }
+}
+
+/*********************************************************************
+ * @fn            - pkt_rx_reset
+ *
+ * @brief         - Prepares the decoder for the next packet.
+ *
+ * @param[in]     - pPktInst: Pointer to the packet handle structure.
+ *
+ * @return        - None
+ *
+ * @Note          - None
+ */
+static void pkt_rx_reset(USART_Pkt_t *pPktInst)
+{
+    pPktInst->RxLen = 0;
+    pPktInst->RxCrc = USART_PKT_CRC_INIT;
+    pPktInst->RxCode = 0;
+    pPktInst->RxZero = 0;
+    pPktInst->RxState = USART_PKT_RX_OK;
+}
+
+/*********************************************************************
+ * @fn            - pkt_rx_put
+ *
+ * @brief         - Stores one decoded byte and adds it to the running CRC.
+ *
+ * @param[in]     - pPktInst: Pointer to the packet handle structure.
+ * @param[in]     - Data: Decoded byte.
+ *
+ * @return        - None
+ *
+ * @Note          - The rest of an oversized packet is discarded.
+ */
+static void pkt_rx_put(USART_Pkt_t *pPktInst, uint8_t Data)
+{
+    if (pPktInst->RxLen >= pPktInst->RxSize)
+    {
+        pPktInst->RxState = USART_PKT_RX_DISCARD;
+        return;
+    }
+
+    pPktInst->pRxBuffer[pPktInst->RxLen++] = Data;
+    pPktInst->RxCrc = pkt_crc16_update(pPktInst->RxCrc, Data);
+}
+
+/*********************************************************************
+ * @fn            - pkt_rx_byte_handle
+ *
+ * @brief         - Decodes one received byte (USART stream handler).
+ *
+ * @param[in]     - pUSARTInst: Pointer to the USART handle structure.
+ * @param[in]     - Data: Byte read from UDR0.
+ *
+ * @return        - None
+ *
+ * @Note          - Runs in the RX ISR. The zero that ends a COBS block is only
+ *                  emitted when the next block starts, so the last one is never stored.
+ */
+static void pkt_rx_byte_handle(USART_t *pUSARTInst, uint8_t Data)
+{
+    USART_Pkt_t *pPktInst = (USART_Pkt_t *)pUSARTInst->pRxContext;
+
+    if (Data == USART_PKT_DELIMITER)
+    {
+        if (pPktInst->RxLen == 0 && pPktInst->RxState == USART_PKT_RX_OK)
+        {
+            // Back to back delimiters, nothing to report
+        }
+        else if ((pPktInst->RxState == USART_PKT_RX_OK) && (pPktInst->RxCode == 0) &&
+                 (pPktInst->RxLen >= USART_PKT_CRC_LEN) && (pPktInst->RxCrc == 0))
+        {
+            // The CRC over payload + CRC leaves a zero remainder
+            USART_PktReceivedCallback(pPktInst, pPktInst->pRxBuffer, pPktInst->RxLen - USART_PKT_CRC_LEN);
+        }
+        else if (pPktInst->RxDropped < 0xFFFF)
+        {
+            pPktInst->RxDropped++;
+        }
+
+        pkt_rx_reset(pPktInst);
+        return;
+    }
+
+    if (pPktInst->RxState == USART_PKT_RX_DISCARD)
+    {
+        // Wait for the next delimiter to resynchronize
+        return;
+    }
+
+    if (pPktInst->RxCode == 0)
+    {
+        // Code byte: close the previous block and open a new one
+        if (pPktInst->RxZero)
+        {
+            pkt_rx_put(pPktInst, 0);
+        }
+        pPktInst->RxCode = Data - 1;
+        pPktInst->RxZero = (Data != 0xFF);
+    }
+    else
+    {
+        pkt_rx_put(pPktInst, Data);
+        pPktInst->RxCode--;
+    }
+}
+
+/*********************************************************************
+ * @fn            - USART_PktInit
+ *
+ * @brief         - Attaches a packet channel to a USART and starts reception.
+ *
+ * @param[in]     - pPktInst: Pointer to the packet handle structure.
+ * @param[in]     - pUSARTInst: Pointer to an initialized USART handle.
+ * @param[in]     - pRxBuffer: Buffer for received packets (payload + 2 CRC bytes).
+ * @param[in]     - Size: Size of pRxBuffer.
+ *
+ * @return        - None
+ *
+ * @Note          - Global interrupts must be enabled for reception and for the
+ *                  transmit ring to drain.
+ */
+void USART_PktInit(USART_Pkt_t *pPktInst, USART_t *pUSARTInst, uint8_t *pRxBuffer, uint16_t Size)
+{
+    pPktInst->pUSART = pUSARTInst;
+    pPktInst->pRxBuffer = pRxBuffer;
+    pPktInst->RxSize = Size;
+    pPktInst->RxDropped = 0;
+    pkt_rx_reset(pPktInst);
+
+    // Decode every received byte in the RX ISR, the channel travels with the USART
+    pUSARTInst->pRxContext = pPktInst;
+    USART_RxStreamControl(pUSARTInst, pkt_rx_byte_handle);
+}
+
+/*********************************************************************
+ * @fn            - USART_PktSend
+ *
+ * @brief         - Sends one packet: payload, CRC-16 and delimiter, COBS encoded.
+ *
+ * @param[in]     - pPktInst: Pointer to the packet handle structure.
+ * @param[in]     - pData: Payload to send.
+ * @param[in]     - Len: Payload length.
+ *
+ * @return        - None
+ *
+ * @Note          - The packet is encoded block by block straight into the USART
+ *                  transmit ring; the call only waits while the ring is full.
+ *                  Do not call it from USART_PktReceivedCallback.
+ */
+void USART_PktSend(USART_Pkt_t *pPktInst, const uint8_t *pData, uint16_t Len)
+{
+    USART_t *pUSARTInst = pPktInst->pUSART;
+    uint16_t crc = USART_PktCrc16(USART_PKT_CRC_INIT, pData, Len);
+    uint8_t  tail[USART_PKT_CRC_LEN] = { (uint8_t)(crc >> 8), (uint8_t)crc };
+    uint16_t total = Len + USART_PKT_CRC_LEN;
+    uint16_t start = 0;
+
+    // Encode payload + CRC as one stream of COBS blocks
+    for (;;)
+    {
+        uint16_t end = start;
+        uint8_t  code;
+
+        // A block runs up to the next zero or 254 non-zero bytes
+        while ((end < total) && ((end - start) < 254) &&
+               (((end < Len) ? pData[end] : tail[end - Len]) != 0))
+        {
+            end++;
+        }
+
+        code = (uint8_t)(end - start + 1);
+        pkt_write(pUSARTInst, &code, 1);
+
+        // Copy the block, it may span the end of the payload and the CRC
+        if (start < Len)
+        {
+            pkt_write(pUSARTInst, &pData[start], ((end < Len) ? end : Len) - start);
+        }
+        if (end > Len)
+        {
+            uint16_t from = (start > Len) ? start : Len;
+            pkt_write(pUSARTInst, &tail[from - Len], end - from);
+        }
+
+        if (end >= total)
+        {
+            break;
+        }
+
+        // Skip the zero replaced by the code byte; a 254 byte block carries none
+        start = (code == 0xFF) ? end : end + 1;
+    }
+
+    // Close the packet
+    tail[0] = USART_PKT_DELIMITER;
+    pkt_write(pUSARTInst, tail, 1);
+}
+
+/*********************************************************************
+ * @fn            - USART_PktCrc16
+ *
+ * @brief         - Computes a CRC-16/CCITT over a buffer.
+ *
+ * @param[in]     - Crc: Initial value (USART_PKT_CRC_INIT for a new packet).
+ * @param[in]     - pData: Data to process.
+ * @param[in]     - Len: Number of bytes.
+ *
+ * @return        - Updated CRC value.
+ *
+ * @Note          - None
+ */
+uint16_t USART_PktCrc16(uint16_t Crc, const uint8_t *pData, uint16_t Len)
+{
+    while (Len--)
+    {
+        Crc = pkt_crc16_update(Crc, *pData++);
+    }
+    return Crc;
+}
+
+/*********************************************************************
+ * @fn            - USART_PktReceivedCallback
+ *
+ * @brief         - Weak implementation of the packet received callback.
+ *
+ * @param[in]     - pPktInst: Pointer to the packet handle structure.
+ * @param[in]     - pData: Decoded payload (CRC already checked and removed).
+ * @param[in]     - Len: Payload length.
+ *
+ * @return        - None
+ *
+ * @Note          - Called from the RX ISR; pData is reused for the next packet
+ *                  as soon as the callback returns.
+ */
+__attribute__((weak)) void USART_PktReceivedCallback(USART_Pkt_t *pPktInst, uint8_t *pData, uint16_t Len)
+{
+    // Implementation here
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -1,37 +1,141 @@
 #include <stdio.h>
 #include <stddef.h>
-#include <avr/io.h>
+#include "syscalls.h"
 
 typedef long ssize_t;
 
+// Single owner of USART0 for stdio, every backend goes through this handle
+USART_t uart_stdio;
+
+// Backend selected by UART_StdioInit (UART_STDIO_BLOCKING/BUFFERED/IT)
+static uint8_t stdio_backend = UART_STDIO_BLOCKING;
+
+/*********************************************************************
+ * @fn            - stdio_wait
+ *
+ * @brief         - Body of the busy loops of the ring backends.
+ *
+ * @param[in]     - None
+ *
+ * @return        - None
+ *
+ * @Note          - With global interrupts disabled the ISR cannot run, so the
+ *                  handler is called by hand to keep the rings moving.
+ */
+static void stdio_wait(void)
+{
+    if (!(CPU_SREG_REG & (1 << 7)))
+    {
+        USART_IRQHandling(&uart_stdio);
+    }
+}
+
+/*********************************************************************
+ * @fn            - UART_StdioInit
+ *
+ * @brief         - Configures uart_stdio as 8N1 and selects the stdio backend.
+ *
+ * @param[in]     - baud: One of the USART_STD_BAUD_x values (or USART_BAUD(bps)).
+ * @param[in]     - mode: USART_MODE_ONLY_TX, USART_MODE_ONLY_RX or USART_MODE_TXRX.
+ * @param[in]     - backend: UART_STDIO_BLOCKING, UART_STDIO_BUFFERED or UART_STDIO_IT.
+ *
+ * @return        - None
+ *
+ * @Note          - The buffered and interrupt backends need global interrupts and
+ *                  the USART vectors routed to uart_stdio (see syscalls.h).
+ */
+void UART_StdioInit(uint16_t baud, uint8_t mode, uint8_t backend)
+{
+    uart_stdio.pReg = USART;
+    uart_stdio.Config.USART_Baud = baud;
+    uart_stdio.Config.USART_Mode = mode;
+    uart_stdio.Config.USART_NoOfStopBits = USART_STOPBITS_1;
+    uart_stdio.Config.USART_ParityControl = USART_PARITY_DISABLE;
+    uart_stdio.Config.USART_WordLength = USART_WORDLEN_8BITS;
+    uart_stdio.Config.USART_MPCM = DISABLE;
+
+    stdio_backend = backend;
+    USART_Init(&uart_stdio);
+
+    // Only the interrupt backend receives through the RX ring
+    if ((backend == UART_STDIO_IT) && (mode != USART_MODE_ONLY_TX))
+    {
+        USART_RxRingControl(&uart_stdio, ENABLE);
+    }
+}
+
 void UART_Init(unsigned int ubrr)
 {
-    UBRR0H = (unsigned char)(ubrr >> 8);
-    UBRR0L = (unsigned char)ubrr;
-    UCSR0B = (1 << RXEN0) | (1 << TXEN0);
-    UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+    // A raw UBRR0 value is a valid USART_Baud with U2X0 cleared
+    UART_StdioInit((uint16_t)ubrr, USART_MODE_TXRX, UART_STDIO_BLOCKING);
 }
 
 void UART_Init_Stdin(unsigned int ubrr)
 {
-    UBRR0H = (unsigned char)(ubrr >> 8);
-    UBRR0L = (unsigned char)ubrr;
-    UCSR0B = (1 << RXEN0);
-    UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+    UART_StdioInit((uint16_t)ubrr, USART_MODE_ONLY_RX, UART_STDIO_BLOCKING);
 }
 
 void UART_Transmit(char data)
 {
-    while (!(UCSR0A & (_BV(UDRE0))) )
-        ;
-    UDR0 = data;
+    USART_SendData(&uart_stdio, (uint8_t *)&data, 1);
+}
+
+/*********************************************************************
+ * @fn            - UART_Flush
+ *
+ * @brief         - Blocks until every queued stdout character was sent.
+ *
+ * @return        - None
+ */
+void UART_Flush(void)
+{
+    // With the blocking backend nothing is queued in software, USART_Flush only
+    // waits on TXC0 until the last character left the shift register
+    USART_Flush(&uart_stdio);
+}
+
+/*********************************************************************
+ * @fn            - UART_Write
+ *
+ * @brief         - Sends a block of characters through the selected stdio backend.
+ *
+ * @param[in]     - pData: Characters to send.
+ * @param[in]     - Len: Number of characters.
+ *
+ * @return        - None
+ *
+ * @Note          - The ring backends return once the last character is queued,
+ *                  and only wait while the TX ring is full.
+ */
+void UART_Write(const char *pData, uint16_t Len)
+{
+    if (stdio_backend == UART_STDIO_BLOCKING)
+    {
+        USART_SendData(&uart_stdio, (uint8_t *)pData, Len);
+        return;
+    }
+
+    while (Len)
+    {
+        uint16_t n = USART_Write(&uart_stdio, (const uint8_t *)pData, Len);
+
+        if (n == 0)
+        {
+            stdio_wait();
+        }
+
+        pData += n;
+        Len -= n;
+    }
 }
 
 int _write(char var, FILE *stream)
 {
     // translate \n to \r for br@y++ terminal
     //if (var == '\n') usart_putchar('\r');
-    UART_Transmit(var);
+
+    UART_Write(&var, 1);
+
     return 0;
     
 }
@@ -39,9 +143,20 @@ int _write(char var, FILE *stream)
 // Función de lectura para stdin (UART)
 int _read(FILE *stream)
 {
-    while (!(UCSR0A & (1 << RXC0)))  // Espera hasta que haya datos disponibles para recibir
-        ;
-    return (UDR0);  // Retorna el dato recibido
+    uint8_t data;
+
+    if (stdio_backend != UART_STDIO_IT)
+    {
+        // Espera hasta que haya datos disponibles para recibir
+        USART_ReceiveData(&uart_stdio, &data, 1);
+        return data;  // Retorna el dato recibido
+    }
+
+    while (USART_Read(&uart_stdio, &data, 1) == 0)
+    {
+        stdio_wait();
+    }
+    return data;
 }
 
 // Custom FILE structure to direct stdout to UART
@@ -0,0 +1,343 @@
+/*
+ * @file              xprintf.c
+ *
+ * @brief             Small printf for the ATmega328P stdio USART.
+ *
+ * @details           Formats come from flash (xprintf wraps them in PSTR) and are
+ *                    parsed with pgm_read_byte. The text is collected in a
+ *                    XPRINTF_CHUNK byte buffer on the stack and handed to UART_Write
+ *                    when it fills and at the end of each call, so no heap and no
+ *                    avr-libc vfprintf are needed. Numbers are converted with 16-bit
+ *                    division whenever the value fits.
+ *
+ * @note              Supported conversions are listed in xprintf.h.
+ */
+
+#include <string.h>
+#include "xprintf.h"
+
+/*
+ * Output chunk, flushed to UART_Write when full and at the end of each call
+ */
+typedef struct
+{
+    uint8_t Len;
+    char    Buf[XPRINTF_CHUNK];
+}xprintf_out_t;
+
+/*********************************************************************
+ * @fn            - xout_flush
+ *
+ * @brief         - Sends the collected characters.
+ *
+ * @param[in]     - pOut: Output chunk.
+ *
+ * @return        - None
+ */
+static void xout_flush(xprintf_out_t *pOut)
+{
+    if (pOut->Len)
+    {
+        UART_Write(pOut->Buf, pOut->Len);
+        pOut->Len = 0;
+    }
+}
+
+/*********************************************************************
+ * @fn            - xout_putc
+ *
+ * @brief         - Appends one character to the output chunk.
+ *
+ * @param[in]     - pOut: Output chunk.
+ * @param[in]     - c: Character.
+ *
+ * @return        - None
+ */
+static void xout_putc(xprintf_out_t *pOut, char c)
+{
+    pOut->Buf[pOut->Len++] = c;
+
+    if (pOut->Len == XPRINTF_CHUNK)
+    {
+        xout_flush(pOut);
+    }
+}
+
+/*********************************************************************
+ * @fn            - xout_pad
+ *
+ * @brief         - Appends a fill character a number of times.
+ *
+ * @param[in]     - pOut: Output chunk.
+ * @param[in]     - c: Fill character.
+ * @param[in]     - n: Count.
+ *
+ * @return        - None
+ */
+static void xout_pad(xprintf_out_t *pOut, char c, uint8_t n)
+{
+    while (n--)
+    {
+        xout_putc(pOut, c);
+    }
+}
+
+/*********************************************************************
+ * @fn            - xprintf_utoa
+ *
+ * @brief         - Converts a number to digits, written backwards.
+ *
+ * @param[in]     - pEnd: One past the last digit of the destination.
+ * @param[in]     - value: Number to convert.
+ * @param[in]     - base: 10 or 16.
+ * @param[in]     - alpha: 'a' or 'A', first letter of the hexadecimal digits.
+ *
+ * @return        - Number of digits (at least one).
+ *
+ * @Note          - Values that fit in 16 bits use 16-bit division, which is
+ *                  several times cheaper than the 32-bit one on the AVR.
+ */
+static uint8_t xprintf_utoa(char *pEnd, uint32_t value, uint8_t base, char alpha)
+{
+    char *p = pEnd;
+
+    if (base == 16)
+    {
+        do
+        {
+            uint8_t d = (uint8_t)value & 0x0F;
+
+            *--p = (d < 10) ? (char)('0' + d) : (char)(alpha + d - 10);
+            value >>= 4;
+        } while (value);
+    }
+    else
+    {
+        while (value > 0xFFFFUL)
+        {
+            *--p = (char)('0' + (uint8_t)(value % 10));
+            value /= 10;
+        }
+
+        uint16_t v = (uint16_t)value;
+
+        do
+        {
+            *--p = (char)('0' + (uint8_t)(v % 10));
+            v /= 10;
+        } while (v);
+    }
+
+    return (uint8_t)(pEnd - p);
+}
+
+/*********************************************************************
+ * @fn            - xvprintf_P
+ *
+ * @brief         - Formats an argument list to the stdio USART.
+ *
+ * @param[in]     - pFmt_P: Format string in flash (see xprintf.h).
+ * @param[in]     - ap: Arguments.
+ *
+ * @return        - None
+ *
+ * @Note          - Unknown conversions are printed as the conversion character.
+ */
+void xvprintf_P(const char *pFmt_P, va_list ap)
+{
+    xprintf_out_t out;
+    char num[10];
+    char c;
+
+    out.Len = 0;
+
+    while ((c = (char)pgm_read_byte(pFmt_P++)) != '\0')
+    {
+        if (c != '%')
+        {
+            xout_putc(&out, c);
+            continue;
+        }
+
+        uint8_t left = 0, zero = 0, is_long = 0, neg = 0, flash = 0;
+        uint8_t width = 0, len = 0;
+        const char *p = num;
+
+        c = (char)pgm_read_byte(pFmt_P++);
+        if (c == '-')
+        {
+            left = 1;
+            c = (char)pgm_read_byte(pFmt_P++);
+        }
+        if (c == '0')
+        {
+            zero = 1;
+            c = (char)pgm_read_byte(pFmt_P++);
+        }
+        while ((c >= '0') && (c <= '9'))
+        {
+            width = (uint8_t)(width * 10 + (c - '0'));
+            c = (char)pgm_read_byte(pFmt_P++);
+        }
+        if (c == 'l')
+        {
+            is_long = 1;
+            c = (char)pgm_read_byte(pFmt_P++);
+        }
+
+        if (c == '\0')
+            break;
+
+        switch (c)
+        {
+        case 'c':
+            num[0] = (char)va_arg(ap, int);
+            len = 1;
+            break;
+
+        case 's':
+        case 'S':
+            p = va_arg(ap, const char *);
+            flash = (c == 'S');
+            // The length only matters for padding
+            if (width)
+                len = (uint8_t)(flash ? strlen_P(p) : strlen(p));
+            break;
+
+        case 'd':
+        case 'u':
+        case 'x':
+        case 'X':
+        {
+            uint32_t value;
+
+            if (c == 'd')
+            {
+                int32_t s = is_long ? va_arg(ap, int32_t) : (int32_t)va_arg(ap, int);
+
+                neg = (s < 0);
+                value = neg ? (uint32_t)0 - (uint32_t)s : (uint32_t)s;
+            }
+            else
+            {
+                value = is_long ? va_arg(ap, uint32_t) : (uint32_t)va_arg(ap, unsigned int);
+            }
+
+            len = xprintf_utoa(&num[sizeof(num)], value, (c == 'd' || c == 'u') ? 10 : 16,
+                               (c == 'X') ? 'A' : 'a');
+            p = &num[sizeof(num) - len];
+            break;
+        }
+
+        default:
+            // '%%' and unsupported conversions
+            xout_putc(&out, c);
+            continue;
+        }
+
+        uint8_t fill = (width > len + neg) ? (uint8_t)(width - len - neg) : 0;
+
+        if (!left && !zero)
+            xout_pad(&out, ' ', fill);
+        if (neg)
+            xout_putc(&out, '-');
+        if (!left && zero)
+            xout_pad(&out, '0', fill);
+
+        if (c == 's' || c == 'S')
+        {
+            char ch;
+
+            while ((ch = flash ? (char)pgm_read_byte(p) : *p) != '\0')
+            {
+                xout_putc(&out, ch);
+                p++;
+            }
+        }
+        else
+        {
+            for (uint8_t i = 0; i < len; i++)
+            {
+                xout_putc(&out, p[i]);
+            }
+        }
+
+        if (left)
+            xout_pad(&out, ' ', fill);
+    }
+
+    xout_flush(&out);
+}
+
+/*********************************************************************
+ * @fn            - xprintf_P
+ *
+ * @brief         - Formats text to the stdio USART.
+ *
+ * @param[in]     - pFmt_P: Format string in flash (see xprintf.h).
+ * @param[in]     - ...: Arguments.
+ *
+ * @return        - None
+ *
+ * @Note          - Use the xprintf() macro for literal formats.
+ */
+void xprintf_P(const char *pFmt_P, ...)
+{
+    va_list ap;
+
+    va_start(ap, pFmt_P);
+    xvprintf_P(pFmt_P, ap);
+    va_end(ap);
+}
+
+/*********************************************************************
+ * @fn            - xputs_P
+ *
+ * @brief         - Sends a string in flash to the stdio USART.
+ *
+ * @param[in]     - pStr_P: String in flash.
+ *
+ * @return        - None
+ *
+ * @Note          - Unlike puts, no line end is added.
+ */
+void xputs_P(const char *pStr_P)
+{
+    xprintf_out_t out;
+    char c;
+
+    out.Len = 0;
+
+    while ((c = (char)pgm_read_byte(pStr_P++)) != '\0')
+    {
+        xout_putc(&out, c);
+    }
+
+    xout_flush(&out);
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
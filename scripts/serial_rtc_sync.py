@@ -15,15 +15,79 @@
 # 4. Sends the formatted date and time to the microcontroller
 #    via UART for synchronization with the system clock.
 #
+# With --binary the date and time are sent as one packet of the
+# USART packet layer instead (see 016serial_time_sync.c):
+#    'T' + seconds, minutes, hours, weekday, date, month, year
+#    as packed BCD (DS1307 register order), followed by a
+#    CRC-16/CCITT (poly 0x1021, init 0xFFFF, big endian), COBS
+#    encoded and terminated by a 0x00 delimiter.
+#
 # This allows the microcontroller to update its internal 
 # clock based on the host system's time.
 # ============================================================
+import argparse
 import serial
 from datetime import datetime
 
+TSYNC_MSG_ID = 0x54  # 'T'
+
+
+def to_bcd(value):
+    return ((value // 10) << 4) | (value % 10)
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def build_sync_packet(now, day_of_week):
+    payload = bytes([
+        TSYNC_MSG_ID,
+        to_bcd(now.second),
+        to_bcd(now.minute),
+        to_bcd(now.hour),
+        day_of_week,
+        to_bcd(now.day),
+        to_bcd(now.month),
+        to_bcd(now.year % 100),
+    ])
+    crc = crc16_ccitt(payload)
+    return cobs_encode(payload + bytes([crc >> 8, crc & 0xFF])) + b"\x00"
+
+
 def main():
+    parser = argparse.ArgumentParser(description="Synchronize the RTC with the host clock")
+    parser.add_argument("--port", default="COM4", help="serial port (default: COM4)")
+    parser.add_argument("--binary", action="store_true",
+                        help="send a binary sync packet instead of the text line")
+    args = parser.parse_args()
+
     # Serial port configuration
-    port = "COM4"  # Update this to the correct port
+    port = args.port  # Update this to the correct port
     baudrate = 9600
     timeout = 5  # Timeout for reading in seconds
 
@@ -38,12 +102,17 @@ def main():
             # Adjust day of the week so Sunday is 1, Monday is 2, ..., Saturday is 7
             day_of_week = (now.weekday() + 1) % 7 + 1  # Convert: Monday=2, Sunday=1, ..., Saturday=7
 
-            # Format: YYYY-MM-DD D HH:MM:SS (D: day of the week as a number)
-            formatted_time = now.strftime(f"%Y-%m-%d {day_of_week} %H:%M:%S")
-            print(f"Sending: {formatted_time}")
+            if args.binary:
+                packet = build_sync_packet(now, day_of_week)
+                print(f"Sending: {now:%Y-%m-%d %H:%M:%S} as {packet.hex(' ')}")
+                ser.write(packet)
+            else:
+                # Format: YYYY-MM-DD D HH:MM:SS (D: day of the week as a number)
+                formatted_time = now.strftime(f"%Y-%m-%d {day_of_week} %H:%M:%S")
+                print(f"Sending: {formatted_time}")
 
-            # Send the date and time to the microcontroller
-            ser.write((formatted_time + "\n").encode('utf-8'))
+                # Send the date and time to the microcontroller
+                ser.write((formatted_time + "\n").encode('utf-8'))
 
     except serial.SerialException as e:
         print(f"Serial error: {e}")
@@ -52,4 +121,4 @@ def main():
         print("\nExiting...")
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
@@ -10,14 +10,7 @@
  * 
  */
 
-#include <stdio.h>
-
-// Configuración del UART (igual que antes)
-#define F_CPU 16000000UL
-#define BAUD 9600
-#define MY_UBRR F_CPU/16/BAUD-1
-
-extern uart_stdout;
+#include "xprintf.h"
 
 void Delay_ms(uint32_t ms)
 {
@@ -29,17 +22,13 @@ void Delay_ms(uint32_t ms)
     for (volatile uint32_t i = 0; i < (cycles_per_ms * ms); i++);
 }
 
-void UART_Init(unsigned int ubrr);
-
 int main(void)
 {
-     UART_Init(MY_UBRR);
-
-     stdout = &uart_stdout;  // Redirige stdout a UART
+     UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BLOCKING);
 
     while (1)
     {
-        printf("Hello, World!\r\n");
+        xprintf("Hello, World!\r\n");
         Delay_ms(1000);
     }
 
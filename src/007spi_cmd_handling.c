@@ -16,7 +16,7 @@
 
 #include "atmega328p_gpio.h"
 #include "atmega328p_spi.h"
-#include <stdio.h>
+#include "xprintf.h"
 #include <string.h>
 
 //command codes
@@ -40,14 +40,14 @@
 
 #define LED_PIN  13
 
-// Configuración del UART (igual que antes)
-#define F_CPU 16000000UL
-#define BAUD 9600
-#define MY_UBRR F_CPU/16/BAUD-1
+//gap left after each byte, the slave preloads its next reply meanwhile
+#define SLAVE_BYTE_GAP_MS  1
 
-extern uart_stdout;
-
-void UART_Init(unsigned int ubrr);
+// Output is queued in the USART ring and drained by the UDRE interrupt
+ISR(ISR_USART_UDRE)
+{
+    USART_IRQHandling(&uart_stdio);
+}
 
 void Delay_ms(uint32_t ms) {
     // Assuming the ATmega328P has a 16 MHz clock 
@@ -66,11 +66,11 @@ void SPI_Inits(SPI_t *pSPIInst)
     pSPIInst->Config.CPHA      = SPI_CPHA_LEADING;
     pSPIInst->Config.SCKSpeed  = SPI_SCLK_FOSC_DIV32;
 
-	printf("SPI MODE : %u \n", pSPIInst->Config.Mode);
-	printf("SPI ORDER: %u \n", pSPIInst->Config.DataOrder);
-	printf("SPI CPOL : %u \n", pSPIInst->Config.CPOL);
-	printf("SPI CPHA : %u \n", pSPIInst->Config.CPHA);
-	printf("SPI SCKL : %u \n", pSPIInst->Config.SCKSpeed);
+	xprintf("SPI MODE : %u \n", pSPIInst->Config.Mode);
+	xprintf("SPI ORDER: %u \n", pSPIInst->Config.DataOrder);
+	xprintf("SPI CPOL : %u \n", pSPIInst->Config.CPOL);
+	xprintf("SPI CPHA : %u \n", pSPIInst->Config.CPHA);
+	xprintf("SPI SCKL : %u \n", pSPIInst->Config.SCKSpeed);
 
     SPI_Init(pSPIInst);
 }
@@ -86,6 +86,34 @@ void GPIO_ButtonInit(GPIO_t *button)
     GPIO_Init(*button);
 }
 
+/*
+ * Exchanges bytes with the slave one at a time. The slave answers each byte
+ * from its SPI interrupt, so it needs a gap to load the next reply.
+ */
+static void slave_xfer_paced(SPI_t *pSPIInst, const uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint16_t Len)
+{
+	for (uint16_t i = 0; i < Len; i++)
+	{
+		SPI_TransferData(pSPIInst, (pTxBuffer != NULL) ? &pTxBuffer[i] : NULL,
+		                 (pRxBuffer != NULL) ? &pRxBuffer[i] : NULL, 1);
+		Delay_ms(SLAVE_BYTE_GAP_MS);
+	}
+}
+
+/*
+ * Sends a command code, then clocks back the ack byte once the slave had
+ * time to load it
+ */
+static uint8_t send_command(SPI_t *pSPIInst, uint8_t commandcode)
+{
+	uint8_t ackbyte;
+
+	slave_xfer_paced(pSPIInst, &commandcode, NULL, 1);
+	slave_xfer_paced(pSPIInst, NULL, &ackbyte, 1);
+
+	return ackbyte;
+}
+
 uint8_t SPI_VerifyResponse(uint8_t ackbyte)
 {
 
@@ -103,14 +131,13 @@ int main(void) {
     GPIO_t button;
     GPIO_t ss0 = SPI_SS;
     SPI_t spi_device;
-	uint8_t dummy_write = 0xff;
-	uint8_t dummy_read;
 
-    //printf init
-    UART_Init(MY_UBRR);
-    stdout = &uart_stdout;  // Redirige stdout a UART
+    //xprintf init
+    UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BUFFERED);
+    // xprintf returns once the text is queued
+    IRQ_EN();
     
-    printf("Application is running\n");
+    xprintf("Application is running\n");
     
     //GPIO Button initialization
     GPIO_ButtonInit(&button);
@@ -119,7 +146,7 @@ int main(void) {
     SPI_Inits(&spi_device);
     SPI_SlaveControl(ss0, 1);
 
-	printf("SPI Init. done\n");
+	xprintf("SPI Init. done\n");
 
     // Main loop
     while (1) {
@@ -127,7 +154,7 @@ int main(void) {
         //Wait till button is pressed
         while(GPIO_ReadPin(button));
 
-		printf("Button presed <CMD_LED_CTRL>.\n");
+		xprintf("Button presed <CMD_LED_CTRL>.\n");
 
         //to avoid button de-bouncing related issues 200ms of delay
         Delay_ms(400);
@@ -143,16 +170,7 @@ int main(void) {
         //send command
         SPI_SlaveControl(ss0, 0);
 		Delay_ms(100);
-        SPI_SendData(&spi_device, &commandcode, 1);
-
-        //do dummy read to clear off the SPIF
-		SPI_ReceiveData(&spi_device, &dummy_read, 1);
-
-        //Send some dummy bits (1 byte) fetch the response from the slave
-        SPI_SendData(&spi_device, &dummy_write, 1);
-
-        //read the ack byte received
-		SPI_ReceiveData(&spi_device, &ackbyte, 1);
+        ackbyte = send_command(&spi_device, commandcode);
 
         if( SPI_VerifyResponse(ackbyte))
 		{
@@ -160,10 +178,8 @@ int main(void) {
 			args[1] = LED_ON;
 
 			//send arguments
-			SPI_SendData(&spi_device, args, 2);
-			// dummy read
-			//SPI_ReceiveData(&spi_device, args, 2);
-			printf("COMMAND_LED_CTRL Executed\n");
+			slave_xfer_paced(&spi_device, args, NULL, 2);
+			xprintf("COMMAND_LED_CTRL Executed\n");
 		}
 
         SPI_SlaveControl(ss0, 1);
@@ -174,7 +190,7 @@ int main(void) {
 
 		//wait till button is pressed
 		while(GPIO_ReadPin(button));
-		printf("Button presed <CMD_SENOSR_READ>.\n");
+		xprintf("Button presed <CMD_SENOSR_READ>.\n");
 
 		//to avoid button de-bouncing related issues 200ms of delay
 		Delay_ms(400);
@@ -183,36 +199,22 @@ int main(void) {
 
 		//send command
 		SPI_SlaveControl(ss0, 0);
-		SPI_SendData(&spi_device, &commandcode, 1);
-
-		//do dummy read to clear off the SPIF
-		SPI_ReceiveData(&spi_device, &dummy_read, 1);
-
-		//Send some dummy byte to fetch the response from the slave
-		SPI_SendData(&spi_device, &dummy_write, 1);
-
-		//read the ack byte received
-		SPI_ReceiveData(&spi_device, &ackbyte, 1);
+		ackbyte = send_command(&spi_device, commandcode);
 
 		if( SPI_VerifyResponse(ackbyte))
 		{
 			args[0] = ANALOG_PIN0;
 
 			//send arguments
-			SPI_SendData(&spi_device, args, 1); //sending one byte of
-
-			//do dummy read to clear off the SPIF
-			SPI_ReceiveData(&spi_device, &dummy_read, 1);
+			slave_xfer_paced(&spi_device, args, NULL, 1); //sending one byte of
 
 			//insert some delay so that slave can ready with the data
 			Delay_ms(400);
 
-			//Send some dummy bits (1 byte) fetch the response from the slave
-			SPI_SendData(&spi_device, &dummy_write, 1);
-
+			//Clock the response out of the slave
 			uint8_t analog_read;
-			SPI_ReceiveData(&spi_device, &analog_read, 1);
-			printf("COMMAND_SENSOR_READ %d\n",analog_read);
+			slave_xfer_paced(&spi_device, NULL, &analog_read, 1);
+			xprintf("COMMAND_SENSOR_READ %d\n",analog_read);
 		}
 
 		SPI_SlaveControl(ss0, 1);
@@ -221,7 +223,7 @@ int main(void) {
 
 		//wait till button is pressed
 		while(GPIO_ReadPin(button));
-		printf("Button presed <CMD_LED_READ>.\n");
+		xprintf("Button presed <CMD_LED_READ>.\n");
 
 		//to avoid button de-bouncing related issues 200ms of delay
 		Delay_ms(400);
@@ -230,36 +232,22 @@ int main(void) {
 
 		//send command
 		SPI_SlaveControl(ss0, 0);
-		SPI_SendData(&spi_device, &commandcode, 1);
-
-		//do dummy read to clear off the SPIF
-		SPI_ReceiveData(&spi_device, &dummy_read, 1);
-
-		//Send some dummy byte to fetch the response from the slave
-		SPI_SendData(&spi_device, &dummy_write, 1);
-
-		//read the ack byte received
-		SPI_ReceiveData(&spi_device, &ackbyte, 1);
+		ackbyte = send_command(&spi_device, commandcode);
 
 		if( SPI_VerifyResponse(ackbyte))
 		{
 			args[0] = LED_PIN;
 
 			//send arguments
-			SPI_SendData(&spi_device, args, 1); //sending one byte of
-
-			//do dummy read to clear off the SPIF
-			SPI_ReceiveData(&spi_device, &dummy_read, 1);
+			slave_xfer_paced(&spi_device, args, NULL, 1); //sending one byte of
 
 			//insert some delay so that slave can ready with the data
 			Delay_ms(400);
 
-			//Send some dummy bits (1 byte) fetch the response from the slave
-			SPI_SendData(&spi_device, &dummy_write, 1);
-
+			//Clock the response out of the slave
 			uint8_t led_status;
-			SPI_ReceiveData(&spi_device, &led_status, 1);
-			printf("COMMAND_READ_LED %d\n",led_status);
+			slave_xfer_paced(&spi_device, NULL, &led_status, 1);
+			xprintf("COMMAND_READ_LED %d\n",led_status);
 
 		}
 
@@ -269,7 +257,7 @@ int main(void) {
 
 		//wait till button is pressed
 		while(GPIO_ReadPin(button));
-		printf("Button presed <CMD_PRINT>.\n");
+		xprintf("Button presed <CMD_PRINT>.\n");
 
 		//to avoid button de-bouncing related issues 200ms of delay
 		Delay_ms(400);
@@ -278,16 +266,7 @@ int main(void) {
 
 		//send command
 		SPI_SlaveControl(ss0, 0);
-		SPI_SendData(&spi_device, &commandcode, 1);
-
-		//do dummy read to clear off the SPIF
-		SPI_ReceiveData(&spi_device, &dummy_read, 1);
-
-		//Send some dummy byte to fetch the response from the slave
-		SPI_SendData(&spi_device, &dummy_write, 1);
-
-		//read the ack byte received
-		SPI_ReceiveData(&spi_device, &ackbyte, 1);
+		ackbyte = send_command(&spi_device, commandcode);
 
 		uint8_t message[] = "Hello ! How are you ??";
 		if( SPI_VerifyResponse(ackbyte))
@@ -295,20 +274,14 @@ int main(void) {
 			args[0] = strlen((char*)message);
 
 			//send arguments
-			SPI_SendData(&spi_device, args, 1); //sending length
-
-			//do dummy read to clear off the SPIF
-			SPI_ReceiveData(&spi_device, &dummy_read, 1);
+			slave_xfer_paced(&spi_device, args, NULL, 1); //sending length
 
 			Delay_ms(400);
 
 			//send message
-			for(int i = 0 ; i < args[0] ; i++){
-				SPI_SendData(&spi_device, &message[i], 1);
-				SPI_ReceiveData(&spi_device, &dummy_read, 1);
-			}
+			slave_xfer_paced(&spi_device, message, NULL, args[0]);
 
-			printf("COMMAND_PRINT Executed \n");
+			xprintf("COMMAND_PRINT Executed \n");
 
 		}
 
@@ -317,7 +290,7 @@ int main(void) {
 		//5. CMD_ID_READ
 		//wait till button is pressed
 		while(GPIO_ReadPin(button));
-		printf("Button presed <CMD_ID_READ>.\n");
+		xprintf("Button presed <CMD_ID_READ>.\n");
 
 		//to avoid button de-bouncing related issues 200ms of delay
 		Delay_ms(400);
@@ -326,32 +299,17 @@ int main(void) {
 
 		//send command
 		SPI_SlaveControl(ss0, 0);
-		SPI_SendData(&spi_device, &commandcode, 1);
-
-		//do dummy read to clear off the SPIF
-		SPI_ReceiveData(&spi_device, &dummy_read, 1);
-
-		//Send some dummy byte to fetch the response from the slave
-		SPI_SendData(&spi_device, &dummy_write, 1);
-
-		//read the ack byte received
-		SPI_ReceiveData(&spi_device, &ackbyte, 1);
+		ackbyte = send_command(&spi_device, commandcode);
 
 		uint8_t id[16];
-		uint32_t i=0;
 		if( SPI_VerifyResponse(ackbyte))
 		{
-			//read 10 bytes id from the slave
-			for(  i = 0 ; i < 15 ; i++)
-			{
-				//send dummy byte to fetch data from slave
-				SPI_SendData(&spi_device, &dummy_write, 1);
-				SPI_ReceiveData(&spi_device, &id[i], 1);
-			}
+			//read 15 bytes id from the slave, dummy bytes clock them out
+			slave_xfer_paced(&spi_device, NULL, id, 15);
 
 			id[15] = '\0';
 
-			printf("COMMAND_ID : %s \n",id);
+			xprintf("COMMAND_ID : %s \n",id);
 
 		}
 
@@ -363,7 +321,7 @@ int main(void) {
 		//Disable the SPI peripheral
 		SPI_Control(&spi_device, 0);
 
-		printf("SPI Communication Closed\n");
+		xprintf("SPI Communication Closed\n");
 
     }
 
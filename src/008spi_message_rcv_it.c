@@ -10,17 +10,10 @@
  * Monitor the message received in the SWV itm data console.
  *
  */
-#include<stdio.h>
 #include<string.h>
 #include "atmega328p_gpio.h"
 #include "atmega328p_spi.h"
-
-// UART Configuration
-#define F_CPU 16000000UL
-#define BAUD 9600
-#define MY_UBRR F_CPU/16/BAUD-1
-
-extern uart_stdout;
+#include "xprintf.h"
 
 GPIO_t IntPin;
 SPI_t spi_device;
@@ -37,8 +30,6 @@ volatile uint8_t rcvStop = 0;
 /*This flag will be set in the interrupt handler of the Arduino interrupt GPIO */
 volatile uint8_t dataAvailable = 0;
 
-void UART_Init(unsigned int ubrr);
-
 void Delay_ms(uint32_t ms) {
     // Assuming the ATmega328P has a 16 MHz clock 
     // Each iteration of the 'for' loop takes approximately 4 clock cycles
@@ -77,19 +68,16 @@ void Slave_GPIO_InterrupPinInit(void)
 }
 int main(void) {
     // Initialize necessary components
-    uint8_t dummy = 0xff;
     GPIO_t ss0 = SPI_SS;
 
-    UART_Init(MY_UBRR);
-
-    stdout = &uart_stdout;  // Redirige stdout a UART
+    UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BLOCKING);
 
 	Slave_GPIO_InterrupPinInit();
-    printf("Interrup Pin Init\n");
+    xprintf("Interrup Pin Init\n");
 
 	//This function is used to initialize the SPI peripheral parameters
 	SPI_Inits();
-    printf("SPI Init\n");
+    xprintf("SPI Init\n");
 
     SPI_SlaveControl(ss0, 1);
 
@@ -110,9 +98,9 @@ int main(void) {
 
         while(!rcvStop)
 		{
-			/* fetch the data from the SPI peripheral byte by byte in interrupt mode */
-			while ( SPI_SendDataIT(&spi_device, &dummy, 1) == SPI_BUSY_IN_TX);
-			while ( SPI_ReceiveDataIT(&spi_device, (uint8_t*)&ReadByte, 1) == SPI_BUSY_IN_RX );
+			/* fetch the data from the SPI peripheral byte by byte in interrupt mode,
+			   the driver clocks out FillByte (0xFF) for each byte */
+			while ( SPI_ReceiveDataIT(&spi_device, (uint8_t*)&ReadByte, 1) != SPI_READY );
 		}
 
 		// confirm SPI is not busy
@@ -122,7 +110,7 @@ int main(void) {
 		//Disable the SPI peripheral
 		SPI_Control(&spi_device, DISABLE);
 
-		printf("Rcvd data = %s\n",RcvBuff);
+		xprintf("Rcvd data = %s\n",RcvBuff);
 
 		dataAvailable = 0;
 
@@ -155,7 +143,7 @@ void SPI_ApplicationEventCallback(SPI_t *pSPIInst, uint8_t AppEv)
 
 ISR(ISR_INT0)
 {
-    printf("Pin interrup triggered\n");
+    xprintf("Pin interrup triggered\n");
     dataAvailable = 1;
 }
 
@@ -9,23 +9,13 @@
  * and date via UART or LCD. Supports 12/24-hour formats and real-time updates.
  *
  */
-#include <stdio.h>
+#include "xprintf.h"
 #include "lcd.h"
 #include "ds1307.h"
 
 /* Enable this macro if you want to test RTC on LCD */
 //#define PRINT_LCD
 
-#ifndef PRINT_LCD 
-
-#define F_CPU 16000000UL
-#define BAUD 9600
-#define MY_UBRR F_CPU/16/BAUD-1
-extern uart_stdout;
-void UART_Init(unsigned int ubrr);
-
-#endif
-
 void Show_timendate(void);
 
 void Delay_ms(uint32_t ms)
@@ -99,10 +89,9 @@ int main(void) {
 	RTC_date_t current_date;
 
 #ifndef PRINT_LCD
-	UART_Init(MY_UBRR);
-	stdout = &uart_stdout;
+	UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BLOCKING);
 	
-	printf("RTC test\n\r");
+	xprintf("RTC test\n\r");
 #else
 	lcd_init();
 
@@ -116,7 +105,7 @@ int main(void) {
 #endif
 
 	if(ds1307_init()){
-		printf("RTC init has failed\n\r");
+		xprintf("RTC init has failed\n\r");
 		while(1);
 	}
 
@@ -140,21 +129,21 @@ int main(void) {
 	if(current_time.time_format != TIME_FORMAT_24HRS){
 		am_pm = (current_time.time_format) ? "PM" : "AM";
 #ifndef PRINT_LCD
-		printf("Current time = %s %s\n\r",time_to_string(&current_time),am_pm); // 04:25:41 PM
+		xprintf("Current time = %s %s\n\r",time_to_string(&current_time),am_pm); // 04:25:41 PM
 #else
 		lcd_print_string(time_to_string(&current_time));
 		lcd_print_string(am_pm);
 #endif
 	}else{
 #ifndef PRINT_LCD
-		printf("Current time = %s\n\r",time_to_string(&current_time)); // 04:25:41
+		xprintf("Current time = %s\n\r",time_to_string(&current_time)); // 04:25:41
 #else
 		lcd_print_string(time_to_string(&current_time));
 #endif
 	}
 
 #ifndef PRINT_LCD
-	printf("Current date = %s <%s>\n\r",date_to_string(&current_date), get_day_of_week(current_date.day));
+	xprintf("Current date = %s <%s>\n\r",date_to_string(&current_date), get_day_of_week(current_date.day));
 #else
 	lcd_set_cursor(2, 1);
 	lcd_print_string(date_to_string(&current_date));
@@ -180,7 +169,7 @@ void Show_timendate(void)
 	if(current_time.time_format != TIME_FORMAT_24HRS){
 		am_pm = (current_time.time_format) ? "PM" : "AM";
 #ifndef PRINT_LCD
-		printf("Current time = %s %s\n\r",time_to_string(&current_time),am_pm); // 04:25:41 PM
+		xprintf("Current time = %s %s\n\r",time_to_string(&current_time),am_pm); // 04:25:41 PM
 #else
 		lcd_set_cursor(1, 1);
 		lcd_print_string(time_to_string(&current_time));
@@ -189,7 +178,7 @@ void Show_timendate(void)
 
 	}else{
 #ifndef PRINT_LCD
-		printf("Current time = %s\n\r",time_to_string(&current_time)); // 04:25:41
+		xprintf("Current time = %s\n\r",time_to_string(&current_time)); // 04:25:41
 #else
 		lcd_set_cursor(1, 1);
 		lcd_print_string(time_to_string(&current_time));
@@ -199,7 +188,7 @@ void Show_timendate(void)
 	ds1307_get_current_date(&current_date);
 
 #ifndef PRINT_LCD
-	printf("Current date = %s <%s>\n\r",date_to_string(&current_date), get_day_of_week(current_date.day));
+	xprintf("Current date = %s <%s>\n\r",date_to_string(&current_date), get_day_of_week(current_date.day));
 #else
 	lcd_set_cursor(2, 1);
 	lcd_print_string(date_to_string(&current_date));
@@ -8,18 +8,35 @@
  * Demonstrates RTC synchronization via UART. The microcontroller requests
  * current date and time from a host script, updates the RTC, and displays it
  * on an LCD screen.
+ * The host (scripts/serial_rtc_sync.py --binary) sends one packet of the USART
+ * packet layer (COBS + CRC-16): 'T' followed by the seven DS1307 registers in
+ * packed BCD. It is decoded in the RX ISR and written to the RTC in one I2C burst.
  *
  */
 
-#include <stdio.h>
 #include "lcd.h"
 #include "ds1307.h"
+#include "atmega328p_usart_pkt.h"
 
-#define F_CPU 16000000UL
-#define BAUD 9600
-#define MY_UBRR F_CPU/16/BAUD-1
-extern FILE uart_stdin;
-void UART_Init_Stdin(unsigned int ubrr);
+/*
+ * Time sync message: id + seconds, minutes, hours, day, date, month, year (BCD)
+ */
+#define TSYNC_MSG_ID        0x54    // 'T'
+#define TSYNC_MSG_LEN       (1 + DS1307_NO_OF_TIME_REGS)
+
+/*
+ * Sync states
+ */
+#define SYNC_WAITING        0
+#define SYNC_READY          1
+#define SYNC_ERROR          2
+
+USART_t uart_device;
+USART_Pkt_t sync_pkt;
+uint8_t sync_rx_buf[TSYNC_MSG_LEN + USART_PKT_CRC_LEN];
+
+volatile uint8_t sync_regs[DS1307_NO_OF_TIME_REGS];
+volatile uint8_t sync_state = SYNC_WAITING;
 
 /* Enable this macro if you want to test RTC on LCD */
 #define PRINT_LCD
@@ -92,13 +109,28 @@ char* date_to_string(RTC_date_t *rtc_date)
 
 }
 
+void UART_Inits(void)
+{
+    uart_device.pReg = USART;
+    uart_device.Config.USART_Baud = USART_STD_BAUD_9600;
+    uart_device.Config.USART_Mode = USART_MODE_ONLY_RX;
+    uart_device.Config.USART_NoOfStopBits = USART_STOPBITS_1;
+    uart_device.Config.USART_ParityControl = USART_PARITY_DISABLE;
+    uart_device.Config.USART_WordLength = USART_WORDLEN_8BITS;
+
+    USART_Init(&uart_device);
+
+    // Packets are decoded byte by byte in the RX ISR
+    USART_PktInit(&sync_pkt, &uart_device, sync_rx_buf, sizeof(sync_rx_buf));
+}
+
 int main(void) {
     // Initialize necessary components
 	RTC_time_t current_time;
 	RTC_date_t current_date;
 
-	UART_Init_Stdin(MY_UBRR);
-	stdin = &uart_stdin;
+	UART_Inits();
+	IRQ_EN();
 
 	lcd_init();
 
@@ -145,49 +177,37 @@ int main(void) {
 }
 
 void Sync_time_and_date(void) {
-    RTC_time_t sync_time;
-    RTC_date_t sync_date;
-
-    char buffer[30];
     lcd_print_string("SYNC_REQUEST"); // Request synchronization
-    
-    // Wait for response (data will come via UART)
-    if (fgets(buffer, sizeof(buffer), stdin)) {
-        int year, month, date, day, hour, minute, second;
-
-        lcd_display_clear();
-        lcd_display_return_home();
-        
-        // Parse the received data (format: YYYY-MM-DD HH:MM:SS)
-        if (sscanf(buffer, "%4d-%2d-%2d %d %2d:%2d:%2d", &year, &month, &date, &day, &hour, &minute, &second) == 7) {
-            // Populate RTC structures
-            sync_date.year = year - 2000; // Adjust to RTC's 2-digit year format
-            sync_date.month = month;
-            sync_date.date = date;
-            sync_date.day = day;
-
-            sync_time.hours = hour;
-            sync_time.minutes = minute;
-            sync_time.seconds = second;
-            sync_time.time_format = TIME_FORMAT_24HRS;
-
-            // Update RTC
-            ds1307_set_current_date(&sync_date);
-            ds1307_set_current_time(&sync_time);
-
-            lcd_print_string("Sync Ok");
-            Delay_ms(2000);
-            lcd_display_clear();
-            lcd_display_return_home();
-
-        } else {
-            // Handle incorrect format or failure
-            lcd_print_string("Sync Error");
-            Delay_ms(2000);
-            lcd_display_clear();
-            lcd_display_return_home();
+
+    // Wait for the packet callback (data will come via UART)
+    while (sync_state == SYNC_WAITING);
+
+    lcd_display_clear();
+    lcd_display_return_home();
+
+    if (sync_state == SYNC_READY) {
+        uint8_t regs[DS1307_NO_OF_TIME_REGS];
+        uint8_t sreg = CPU_SREG_REG;
+
+        // Snapshot the registers written by the packet ISR
+        IRQ_DIS();
+        for (uint8_t i = 0; i < DS1307_NO_OF_TIME_REGS; i++) {
+            regs[i] = sync_regs[i];
         }
+        CPU_SREG_REG = sreg;
+
+        // Update RTC, the registers are already in DS1307 format
+        ds1307_set_bcd(regs);
+
+        lcd_print_string("Sync Ok");
+    } else {
+        // Handle incorrect fields
+        lcd_print_string("Sync Error");
     }
+
+    Delay_ms(2000);
+    lcd_display_clear();
+    lcd_display_return_home();
 }
 
 void Show_timendate(void)
@@ -219,6 +239,40 @@ void Show_timendate(void)
 	lcd_print_char('>');
 }
 
+ISR(ISR_USART_RX)
+{
+    USART_IRQHandling(&uart_device);
+}
+
+/*
+ * Runs in the RX ISR for every packet with a valid CRC
+ */
+void USART_PktReceivedCallback(USART_Pkt_t *pPktInst, uint8_t *pData, uint16_t Len)
+{
+    // Valid range of each register (BCD compares like binary when the digits are valid)
+    static const uint8_t reg_min[DS1307_NO_OF_TIME_REGS] = {0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00};
+    static const uint8_t reg_max[DS1307_NO_OF_TIME_REGS] = {0x59, 0x59, 0x23, 0x07, 0x31, 0x12, 0x99};
+
+    if ((Len != TSYNC_MSG_LEN) || (pData[0] != TSYNC_MSG_ID) || (sync_state != SYNC_WAITING))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < DS1307_NO_OF_TIME_REGS; i++)
+    {
+        uint8_t bcd = pData[1 + i];
+
+        if (((bcd & 0x0F) > 9) || (bcd < reg_min[i]) || (bcd > reg_max[i]))
+        {
+            sync_state = SYNC_ERROR;
+            return;
+        }
+        sync_regs[i] = bcd;
+    }
+
+    sync_state = SYNC_READY;
+}
+
 /*
  * MIT License
  *
@@ -0,0 +1,203 @@
+/*
+ * 017usart_cli.c
+ *
+ * Description:
+ * Demonstrates the USART command interpreter. Commands typed on a terminal
+ * (115200 8N1, CR or LF line end) are tokenized in place in the receive ring and
+ * dispatched through a sorted command table in flash. Replies are queued on the
+ * transmit ring, no stdio is linked.
+ *
+ *   add <a> <b>      prints a + b (signed, decimal or 0x hex)
+ *   help             lists the commands
+ *   led <on|off|t>   drives the LED on PB5
+ *   stats            prints the executed and rejected line counters
+ *
+ */
+#include <avr/pgmspace.h>
+#include "atmega328p_gpio.h"
+#include "atmega328p_usart.h"
+#include "atmega328p_usart_cli.h"
+
+USART_t uart_device;
+USART_Cli_t cli;
+GPIO_t LED;
+
+uint16_t cmd_count = 0;
+uint16_t err_count = 0;
+
+ISR(ISR_USART_RX)
+{
+    USART_IRQHandling(&uart_device);
+}
+
+ISR(ISR_USART_UDRE)
+{
+    USART_IRQHandling(&uart_device);
+}
+
+void print_P(const char *s)
+{
+    uint8_t c;
+
+    while ((c = pgm_read_byte(s++)) != '\0')
+    {
+        // Wait for room instead of dropping the reply
+        while (USART_Write(&uart_device, &c, 1) == 0);
+    }
+}
+
+void print_i32(int32_t value)
+{
+    char buf[11];
+    uint8_t i = sizeof(buf);
+    uint32_t v = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+    do
+    {
+        buf[--i] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v);
+
+    if (value < 0)
+    {
+        while (USART_Write(&uart_device, (const uint8_t *)"-", 1) == 0);
+    }
+
+    while (i < sizeof(buf))
+    {
+        uint16_t n = USART_Write(&uart_device, (const uint8_t *)&buf[i], sizeof(buf) - i);
+        i += n;
+    }
+}
+
+/*
+ * Command handlers
+ */
+void cmd_add(USART_Cli_t *pCli, uint8_t Argc)
+{
+    int32_t a, b;
+
+    if ((Argc != 3) || !USART_CliArgI32(pCli, 1, &a) || !USART_CliArgI32(pCli, 2, &b))
+    {
+        print_P(PSTR("usage: add <a> <b>\r\n"));
+        err_count++;
+        return;
+    }
+
+    print_i32(a + b);
+    print_P(PSTR("\r\n"));
+    cmd_count++;
+}
+
+void cmd_help(USART_Cli_t *pCli, uint8_t Argc);
+
+void cmd_led(USART_Cli_t *pCli, uint8_t Argc)
+{
+    if (USART_CliArgIs(pCli, 1, PSTR("on")))
+        GPIO_WritePin(LED, SET);
+    else if (USART_CliArgIs(pCli, 1, PSTR("off")))
+        GPIO_WritePin(LED, RESET);
+    else if (USART_CliArgIs(pCli, 1, PSTR("t")))
+        GPIO_TogglePin(LED);
+    else
+    {
+        print_P(PSTR("usage: led <on|off|t>\r\n"));
+        err_count++;
+        return;
+    }
+
+    print_P(PSTR("ok\r\n"));
+    cmd_count++;
+}
+
+void cmd_stats(USART_Cli_t *pCli, uint8_t Argc)
+{
+    cmd_count++;
+
+    print_P(PSTR("executed "));
+    print_i32(cmd_count);
+    print_P(PSTR(", rejected "));
+    print_i32(err_count);
+    print_P(PSTR("\r\n"));
+}
+
+/*
+ * Command table, must stay sorted by name
+ */
+const char name_add[]   PROGMEM = "add";
+const char name_help[]  PROGMEM = "help";
+const char name_led[]   PROGMEM = "led";
+const char name_stats[] PROGMEM = "stats";
+
+const USART_CliCmd_t cmd_table[] PROGMEM = {
+    { name_add,   cmd_add   },
+    { name_help,  cmd_help  },
+    { name_led,   cmd_led   },
+    { name_stats, cmd_stats },
+};
+
+#define NO_OF_CMDS  (sizeof(cmd_table) / sizeof(cmd_table[0]))
+
+void cmd_help(USART_Cli_t *pCli, uint8_t Argc)
+{
+    for (uint8_t i = 0; i < NO_OF_CMDS; i++)
+    {
+        print_P((const char *)(uintptr_t)pgm_read_word(&cmd_table[i].pName));
+        print_P(PSTR("\r\n"));
+    }
+    cmd_count++;
+}
+
+/*
+ * Runs in thread context, from USART_CliProcess
+ */
+void USART_CliEventCallback(USART_Cli_t *pCli, uint8_t Event)
+{
+    err_count++;
+
+    if (Event == USART_CLI_EVENT_UNKNOWN)
+        print_P(PSTR("unknown command, try help\r\n"));
+    else if (Event == USART_CLI_EVENT_OVERFLOW)
+        print_P(PSTR("line too long\r\n"));
+    else if (Event == USART_CLI_EVENT_TOO_MANY)
+        print_P(PSTR("too many arguments\r\n"));
+}
+
+void UART_Inits(void)
+{
+    uart_device.pReg = USART;
+    uart_device.Config.USART_Baud = USART_STD_BAUD_115200;
+    uart_device.Config.USART_Mode = USART_MODE_TXRX;
+    uart_device.Config.USART_NoOfStopBits = USART_STOPBITS_1;
+    uart_device.Config.USART_ParityControl = USART_PARITY_DISABLE;
+    uart_device.Config.USART_WordLength = USART_WORDLEN_8BITS;
+
+    USART_Init(&uart_device);
+}
+
+int main(void)
+{
+    LED.GPIOX           = GPIOB;
+    LED.GPIO_Pin.Number = PIN5;
+    LED.GPIO_Pin.Mode   = MODE_OUT;
+    LED.GPIO_Pin.PullUp = PULLUP_DISABLED;
+
+    GPIO_Init(LED);
+
+    UART_Inits();
+
+    // Also arms the receive ring
+    if (USART_CliInit(&cli, &uart_device, cmd_table, NO_OF_CMDS) != USART_CLI_OK)
+        while (1);
+
+    IRQ_EN();
+
+    print_P(PSTR("CLI ready\r\n"));
+
+    while (1)
+    {
+        USART_CliProcess(&cli);
+    }
+
+    return 0;
+}
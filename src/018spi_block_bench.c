@@ -0,0 +1,138 @@
+/*
+ * 018spi_block_bench.c
+ *
+ * Description:
+ * Measures SPI block throughput at F_CPU/2 (8 MHz SCK at 16 MHz). The same
+ * block is sent with SPI_SendData and with SPI_SendBlockFast, then read back
+ * with SPI_ReadBlock and SPI_ReadBlockFast. Timer1 counts CPU cycles and the
+ * results are printed on the UART (9600 8N1). The wire needs 16 cycles per
+ * byte at this clock. No slave is needed, SS (PB2) stays an output.
+ *
+ */
+
+#include "atmega328p_gpio.h"
+#include "atmega328p_spi.h"
+#include "xprintf.h"
+
+#define BLOCK_LEN   512
+
+uint8_t block[BLOCK_LEN];
+
+void Delay_ms(uint32_t ms) {
+    // Assuming the ATmega328P has a 16 MHz clock 
+    // Each iteration of the 'for' loop takes approximately 4 clock cycles
+    // Therefore, a value is needed to adjust the delay duration
+    const uint32_t cycles_per_ms = 471; // 16 MHz / 4 (cycles per instruction) / 1000 ms
+    for (volatile uint32_t i = 0; i < (cycles_per_ms * ms); i++);
+}
+
+/*
+ * Timer1 free running at F_CPU, one count per CPU cycle
+ */
+void Timer1_Start(void)
+{
+    TIM1->TCCR1A = 0;
+    TIM1->TCCR1B = 0;
+    TIM1->TCNT1 = 0;
+    TIM1->TCCR1B = (1 << TIM1_TCCR1B_CS10);
+}
+
+uint16_t Timer1_Stop(void)
+{
+    uint16_t cycles = TIM1->TCNT1;
+
+    TIM1->TCCR1B = 0;
+    return cycles;
+}
+
+void Print_result(const char *name_P, uint16_t cycles)
+{
+    // Cycles per byte with two decimals
+    uint32_t cpb = ((uint32_t)cycles * 100UL) / BLOCK_LEN;
+
+    xputs_P(name_P);
+    xprintf(": %5u cycles, %2u.%02u cycles/byte\r\n", cycles, (uint16_t)(cpb / 100), (uint16_t)(cpb % 100));
+}
+
+int main(void) {
+    SPI_t spi_device;
+    GPIO_t ss0 = SPI_SS;
+    uint16_t cycles;
+
+    UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BLOCKING);
+
+    spi_device.pReg             = SPI;
+    spi_device.Config.Mode      = SPI_MODE_MASTER;
+    spi_device.Config.DataOrder = SPI_ORDER_MSB;
+    spi_device.Config.CPOL      = SPI_CPOL_LOW;
+    spi_device.Config.CPHA      = SPI_CPHA_LEADING;
+    spi_device.Config.SCKSpeed  = SPI_SCLK_FOSC_DIV2;
+
+    SPI_Init(&spi_device);
+    SPI_SlaveControl(ss0, 1);
+
+    for (uint16_t i = 0; i < BLOCK_LEN; i++) {
+        block[i] = (uint8_t)i;
+    }
+
+    xprintf("SPI block benchmark, %u bytes at F_CPU/2, wire: 16.00 cycles/byte\r\n", BLOCK_LEN);
+
+    while (1) {
+        SPI_SlaveControl(ss0, 0);
+        Timer1_Start();
+        SPI_SendData(&spi_device, block, BLOCK_LEN);
+        cycles = Timer1_Stop();
+        SPI_SlaveControl(ss0, 1);
+        Print_result(PSTR("SPI_SendData     "), cycles);
+
+        SPI_SlaveControl(ss0, 0);
+        Timer1_Start();
+        SPI_SendBlockFast(&spi_device, block, BLOCK_LEN);
+        cycles = Timer1_Stop();
+        SPI_SlaveControl(ss0, 1);
+        Print_result(PSTR("SPI_SendBlockFast"), cycles);
+
+        SPI_SlaveControl(ss0, 0);
+        Timer1_Start();
+        SPI_ReadBlock(&spi_device, block, BLOCK_LEN, SPI_DUMMY_BYTE);
+        cycles = Timer1_Stop();
+        SPI_SlaveControl(ss0, 1);
+        Print_result(PSTR("SPI_ReadBlock    "), cycles);
+
+        SPI_SlaveControl(ss0, 0);
+        Timer1_Start();
+        SPI_ReadBlockFast(&spi_device, block, BLOCK_LEN, SPI_DUMMY_BYTE);
+        cycles = Timer1_Stop();
+        SPI_SlaveControl(ss0, 1);
+        Print_result(PSTR("SPI_ReadBlockFast"), cycles);
+
+        Delay_ms(2000);
+    }
+    return 0;
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
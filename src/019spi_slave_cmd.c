@@ -0,0 +1,182 @@
+/*
+ * 019spi_slave_cmd.c
+ *
+ * Description:
+ * Slave side of 007spi_cmd_handling. The SPI slave engine acks the command
+ * codes 0x50..0x54, collects their arguments and runs the handlers from the
+ * SPI interrupt; replies are queued in the slave Tx ring and the PRINT message
+ * arrives in the slave Rx ring. Arduino pin 13 is SCK on the slave, so the
+ * LED commands drive an LED on PD6 instead. SENSOR_READ answers the digital
+ * level of the analog pin (PC0..PC5). Messages are printed on the UART (9600 8N1).
+ * SS going high (PCINT0) drops any unfinished command. The master paces its
+ * bytes so each reply is preloaded in time (see SPI_SlaveStart).
+ *
+ */
+
+#include "atmega328p_gpio.h"
+#include "atmega328p_spi.h"
+#include "xprintf.h"
+
+//command codes
+#define COMMAND_LED_CTRL      		0x50
+#define COMMAND_SENSOR_READ      	0x51
+#define COMMAND_LED_READ      		0x52
+#define COMMAND_PRINT      			0x53
+#define COMMAND_ID_READ      		0x54
+
+//arduino led
+#define LED_PIN  13
+
+#define MSG_MAX  32
+
+SPI_t spi_device;
+GPIO_t led;
+
+volatile uint8_t print_len = 0;
+
+// Output is queued in the USART ring and drained by the UDRE interrupt
+ISR(ISR_USART_UDRE)
+{
+    USART_IRQHandling(&uart_stdio);
+}
+
+ISR(ISR_SPI_STC)
+{
+    SPI_IRQHandling(&spi_device);
+}
+
+// SS (PB2) changes, the slave engine resynchronises on its rising edge
+ISR(ISR_PCINT0)
+{
+    SPI_SlaveSsIRQHandling(&spi_device);
+}
+
+/*
+ * Command handlers, they run in the SPI ISR
+ */
+static uint8_t cmd_led_ctrl(SPI_t *pSPIInst, const uint8_t *pArgs)
+{
+    if (pArgs[0] == LED_PIN) {
+        GPIO_WritePin(led, pArgs[1]);
+    }
+    return 0;
+}
+
+static uint8_t cmd_sensor_read(SPI_t *pSPIInst, const uint8_t *pArgs)
+{
+    GPIO_t analog = {
+        .GPIOX = GPIOC,
+        .GPIO_Pin = { .Number = pArgs[0], .Mode = MODE_IN, .PullUp = PULLUP_DISABLED }
+    };
+    uint8_t value = GPIO_ReadPin(analog);
+
+    SPI_SlaveWrite(pSPIInst, &value, 1);
+    return 0;
+}
+
+static uint8_t cmd_led_read(SPI_t *pSPIInst, const uint8_t *pArgs)
+{
+    uint8_t value = (pArgs[0] == LED_PIN) ? GPIO_ReadPin(led) : 0;
+
+    SPI_SlaveWrite(pSPIInst, &value, 1);
+    return 0;
+}
+
+static uint8_t cmd_print(SPI_t *pSPIInst, const uint8_t *pArgs)
+{
+    // The message follows, it is stored in the slave Rx ring
+    print_len = pArgs[0];
+    return pArgs[0];
+}
+
+static uint8_t cmd_id_read(SPI_t *pSPIInst, const uint8_t *pArgs)
+{
+    static const uint8_t id[15] = "ATmega328P-SPI1";
+
+    SPI_SlaveWrite(pSPIInst, id, sizeof(id));
+    return 0;
+}
+
+static const SPI_SlaveCmd_t commands[] = {
+    { COMMAND_LED_CTRL,    2, cmd_led_ctrl },
+    { COMMAND_SENSOR_READ, 1, cmd_sensor_read },
+    { COMMAND_LED_READ,    1, cmd_led_read },
+    { COMMAND_PRINT,       1, cmd_print },
+    { COMMAND_ID_READ,     0, cmd_id_read },
+};
+
+void SPI_Inits(void)
+{
+    spi_device.pReg             = SPI;
+    spi_device.Config.Mode      = SPI_MODE_SLAVE;
+    spi_device.Config.DataOrder = SPI_ORDER_MSB;
+    spi_device.Config.CPOL      = SPI_CPOL_LOW;
+    spi_device.Config.CPHA      = SPI_CPHA_LEADING;
+    spi_device.Config.SCKSpeed  = SPI_SCLK_FOSC_DIV32;   // Ignored in slave mode
+
+    SPI_Init(&spi_device);
+}
+
+int main(void) {
+    char message[MSG_MAX + 1];
+    uint8_t len = 0;
+
+    UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BUFFERED);
+
+    led.GPIOX           = GPIOD;
+    led.GPIO_Pin.Number = PIN6;
+    led.GPIO_Pin.Mode   = MODE_OUT;
+    led.GPIO_Pin.PullUp = PULLUP_DISABLED;
+    GPIO_Init(led);
+
+    SPI_Inits();
+    SPI_SlaveStart(&spi_device, commands, sizeof(commands) / sizeof(commands[0]));
+
+    IRQ_EN();
+
+    xprintf("SPI slave ready\n");
+
+    while (1) {
+        // Collect the PRINT message from the slave Rx ring
+        while (SPI_SlaveRead(&spi_device, (uint8_t *)&message[len], 1)) {
+            if (len < MSG_MAX) {
+                len++;
+            }
+        }
+
+        if ((print_len != 0) && (len >= print_len || len == MSG_MAX)) {
+            message[len] = '\0';
+            xprintf("Rcvd : %s\n", message);
+            print_len = 0;
+            len = 0;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
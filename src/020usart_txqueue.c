@@ -0,0 +1,155 @@
+/*
+ * 020usart_txqueue.c
+ *
+ * Description:
+ * Streams numbered frames with the USART transmission queue (115200 8N1).
+ * Each frame is three descriptors, a constant header, a payload built in one
+ * of two frame buffers and a constant trailer, sent back to back by the UDRE
+ * interrupt with no copy. The trailer's pDone hands the frame buffer back to
+ * the main loop. CTS flow control on PD2 (INT0, active low, pull-up enabled):
+ * pull it high to pause the stream and release it to resume.
+ *
+ */
+#include <stddef.h>
+#include "atmega328p_gpio.h"
+#include "atmega328p_usart.h"
+
+#define PAYLOAD_MAX   6
+
+typedef struct
+{
+    USART_TxDesc_t Header;
+    USART_TxDesc_t Payload;
+    USART_TxDesc_t Trailer;
+    uint8_t        Data[PAYLOAD_MAX];
+    volatile uint8_t Busy;          // Owned by the driver until the trailer is loaded
+}Frame_t;
+
+static const uint8_t header[]  = "frame ";
+static const uint8_t trailer[] = "\r\n";
+
+USART_t uart_device;
+Frame_t frames[2];
+
+ISR(ISR_USART_UDRE)
+{
+    USART_IRQHandling(&uart_device);
+}
+
+ISR(ISR_INT0)
+{
+    USART_CtsIRQHandling(&uart_device);
+}
+
+/*
+ * Called from the UDRE ISR once the trailer is loaded: the frame can be reused
+ */
+void Frame_done(USART_t *pUSARTInst, USART_TxDesc_t *pDesc)
+{
+    Frame_t *pFrame = (Frame_t *)((uint8_t *)pDesc - offsetof(Frame_t, Trailer));
+
+    pFrame->Busy = 0;
+}
+
+void UART_Inits(void)
+{
+    uart_device.pReg = USART;
+    uart_device.Config.USART_Baud = USART_STD_BAUD_115200;
+    uart_device.Config.USART_Mode = USART_MODE_ONLY_TX;
+    uart_device.Config.USART_NoOfStopBits = USART_STOPBITS_1;
+    uart_device.Config.USART_ParityControl = USART_PARITY_DISABLE;
+    uart_device.Config.USART_WordLength = USART_WORDLEN_8BITS;
+    uart_device.Config.USART_FlowControl = USART_FLOW_CTS;
+
+    uart_device.Config.USART_CtsPin.GPIOX           = GPIOD;
+    uart_device.Config.USART_CtsPin.GPIO_Pin.Number = PIN2;
+    uart_device.Config.USART_CtsPin.GPIO_Pin.PullUp = PULLUP_ENABLED;
+
+    USART_Init(&uart_device);
+}
+
+/*
+ * Writes the frame number in decimal, returns the number of digits
+ */
+uint8_t Frame_number(uint8_t *pData, uint16_t number)
+{
+    uint8_t digits[5];
+    uint8_t len = 0;
+    uint8_t i = 0;
+
+    do {
+        digits[len++] = '0' + (number % 10);
+        number /= 10;
+    } while (number > 0);
+
+    while (len > 0) {
+        pData[i++] = digits[--len];
+    }
+    return i;
+}
+
+int main(void) {
+    uint16_t number = 0;
+    uint8_t slot = 0;
+
+    UART_Inits();
+    USART_PeripheralControl(uart_device.pReg, ENABLE);
+
+    IRQ_EN();
+
+    while (1) {
+        Frame_t *pFrame = &frames[slot];
+
+        // Wait for the frame buffer and for room for its three descriptors
+        if (pFrame->Busy || (USART_TxQueueFree(&uart_device) < 3)) {
+            continue;
+        }
+
+        pFrame->Header.pData  = header;
+        pFrame->Header.Len    = sizeof(header) - 1;
+        pFrame->Header.pDone  = NULL;
+
+        pFrame->Payload.pData = pFrame->Data;
+        pFrame->Payload.Len   = Frame_number(pFrame->Data, number++);
+        pFrame->Payload.pDone = NULL;
+
+        pFrame->Trailer.pData = trailer;
+        pFrame->Trailer.Len   = sizeof(trailer) - 1;
+        pFrame->Trailer.pDone = Frame_done;
+
+        pFrame->Busy = 1;
+        USART_TxEnqueue(&uart_device, &pFrame->Header);
+        USART_TxEnqueue(&uart_device, &pFrame->Payload);
+        USART_TxEnqueue(&uart_device, &pFrame->Trailer);
+
+        slot ^= 1;
+    }
+
+    return 0;
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file
@@ -0,0 +1,255 @@
+/*
+ * 021spi_xfer_queue.c
+ *
+ * Description:
+ * Three devices share the SPI bus through the transaction queue: a MAX7219
+ * display driver (4 digits, CS on PB1, mode 0, F_CPU/4), a W25Q flash (CS on
+ * PB0, mode 0, F_CPU/2) and a MCP3008 ADC (CS on PD7, mode 3, F_CPU/8). The
+ * device register values are folded at compile time with SPI_CONFIG(). Before
+ * the queue starts, the flash status register is read with a blocking transfer
+ * (SPI_ApplyConfig, CS driven by hand). Then the flash JEDEC ID is read once
+ * and channel 0 of the ADC is sampled and shown on the display. The main loop
+ * only queues transactions, the driver switches clock mode and CS between
+ * them and the pDone callbacks hand the buffers back. Results are printed on the UART (9600 8N1). SS (PB2) is not used as a
+ * chip select, it stays an output driven high.
+ *
+ */
+
+#include "atmega328p_gpio.h"
+#include "atmega328p_spi.h"
+#include "xprintf.h"
+
+//MAX7219 registers
+#define MAX7219_DIGIT0          0x01
+#define MAX7219_DECODE_MODE     0x09
+#define MAX7219_INTENSITY       0x0A
+#define MAX7219_SCAN_LIMIT      0x0B
+#define MAX7219_SHUTDOWN        0x0C
+
+#define DISPLAY_DIGITS          4
+
+//W25Q commands
+#define FLASH_READ_STATUS1      0x05
+#define FLASH_JEDEC_ID          0x9F
+
+//MCP3008 single ended channel
+#define ADC_CHANNEL             0
+
+#define ADC_IDLE                0
+#define ADC_BUSY                1
+#define ADC_READY               2
+
+//Clock mode, data order and rate of each device
+static const SPI_RegConfig_t display_cfg = SPI_CONFIG(MASTER, MSB, MODE0, DIV4);
+static const SPI_RegConfig_t flash_cfg   = SPI_CONFIG(MASTER, MSB, MODE0, DIV2);
+static const SPI_RegConfig_t adc_cfg     = SPI_CONFIG(MASTER, MSB, MODE3, DIV8);
+
+SPI_t spi_device;
+SPI_Device_t display;
+SPI_Device_t flash;
+SPI_Device_t adc;
+
+//One transaction per MAX7219 register, CS going high latches it
+static const uint8_t display_init[DISPLAY_DIGITS][2] = {
+    { MAX7219_DECODE_MODE, 0x0F },                 // BCD decode on digits 0..3
+    { MAX7219_INTENSITY,   0x08 },
+    { MAX7219_SCAN_LIMIT,  DISPLAY_DIGITS - 1 },
+    { MAX7219_SHUTDOWN,    0x01 },                 // Normal operation
+};
+uint8_t display_tx[DISPLAY_DIGITS][2];
+SPI_Xfer_t display_xfer[DISPLAY_DIGITS];
+volatile uint8_t display_busy = 0;
+
+static const uint8_t flash_tx[4] = { FLASH_JEDEC_ID, SPI_DUMMY_BYTE, SPI_DUMMY_BYTE, SPI_DUMMY_BYTE };
+uint8_t flash_rx[4];
+SPI_Xfer_t flash_xfer;
+volatile uint8_t flash_ready = 0;
+
+static const uint8_t adc_tx[3] = { 0x01, 0x80 | (ADC_CHANNEL << 4), 0x00 };
+uint8_t adc_rx[3];
+SPI_Xfer_t adc_xfer;
+volatile uint8_t adc_state = ADC_IDLE;
+
+// Output is queued in the USART ring and drained by the UDRE interrupt
+ISR(ISR_USART_UDRE)
+{
+    USART_IRQHandling(&uart_stdio);
+}
+
+ISR(ISR_SPI_STC)
+{
+    SPI_IRQHandling(&spi_device);
+}
+
+void Delay_ms(uint32_t ms) {
+    // Assuming the ATmega328P has a 16 MHz clock 
+    // Each iteration of the 'for' loop takes approximately 4 clock cycles
+    // Therefore, a value is needed to adjust the delay duration
+    const uint32_t cycles_per_ms = 471; // 16 MHz / 4 (cycles per instruction) / 1000 ms
+    for (volatile uint32_t i = 0; i < (cycles_per_ms * ms); i++);
+}
+
+/*
+ * Completion callbacks, they run in the SPI ISR once CS is released
+ */
+void Display_done(SPI_t *pSPIInst, SPI_Xfer_t *pXfer)
+{
+    display_busy--;
+}
+
+void Flash_done(SPI_t *pSPIInst, SPI_Xfer_t *pXfer)
+{
+    flash_ready = 1;
+}
+
+void Adc_done(SPI_t *pSPIInst, SPI_Xfer_t *pXfer)
+{
+    adc_state = ADC_READY;
+}
+
+/*
+ * Fills a transaction and queues it, waiting for a free slot if needed
+ */
+void Xfer_queue(SPI_Xfer_t *pXfer, const SPI_Device_t *pDevice, const uint8_t *pTxBuffer,
+                uint8_t *pRxBuffer, uint16_t Len, void (*pDone)(SPI_t *, SPI_Xfer_t *))
+{
+    pXfer->pDevice   = pDevice;
+    pXfer->pTxBuffer = pTxBuffer;
+    pXfer->pRxBuffer = pRxBuffer;
+    pXfer->Len       = Len;
+    pXfer->pDone     = pDone;
+
+    while (SPI_XferEnqueue(&spi_device, pXfer) != SPI_READY);
+}
+
+void Display_config(void)
+{
+    display_busy = DISPLAY_DIGITS;
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++) {
+        Xfer_queue(&display_xfer[i], &display, display_init[i], NULL, 2, Display_done);
+    }
+}
+
+void Display_write(uint16_t value)
+{
+    display_busy = DISPLAY_DIGITS;
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++) {
+        display_tx[i][0] = MAX7219_DIGIT0 + i;
+        display_tx[i][1] = value % 10;
+        value /= 10;
+        Xfer_queue(&display_xfer[i], &display, display_tx[i], NULL, 2, Display_done);
+    }
+}
+
+void SPI_Inits(void)
+{
+    GPIO_t ss0 = SPI_SS;
+
+    spi_device.pReg             = SPI;
+    spi_device.Config.Mode      = SPI_MODE_MASTER;
+    spi_device.Config.DataOrder = SPI_ORDER_MSB;
+    spi_device.Config.CPOL      = SPI_CPOL_LOW;
+    spi_device.Config.CPHA      = SPI_CPHA_LEADING;
+    spi_device.Config.SCKSpeed  = SPI_SCLK_FOSC_DIV2;
+
+    SPI_Init(&spi_device);
+    SPI_SlaveControl(ss0, 1);
+}
+
+void SPI_DeviceInits(void)
+{
+    GPIO_t cs = { .GPIO_Pin = { .Mode = MODE_OUT, .PullUp = PULLUP_DISABLED } };
+
+    cs.GPIOX = GPIOB;
+    cs.GPIO_Pin.Number = PIN1;
+    SPI_DeviceInit(&display, &display_cfg, cs);
+
+    cs.GPIO_Pin.Number = PIN0;
+    SPI_DeviceInit(&flash, &flash_cfg, cs);
+
+    cs.GPIOX = GPIOD;
+    cs.GPIO_Pin.Number = PIN7;
+    SPI_DeviceInit(&adc, &adc_cfg, cs);
+}
+
+/*
+ * Blocking read of the flash status register, only while the queue is idle
+ */
+uint8_t Flash_status(void)
+{
+    uint8_t tx[2] = { FLASH_READ_STATUS1, SPI_DUMMY_BYTE };
+    uint8_t rx[2];
+
+    SPI_ApplyConfig(&spi_device, flash_cfg);
+    *flash.pCsPort &= ~flash.CsMask;
+    SPI_TransferData(&spi_device, tx, rx, sizeof(tx));
+    *flash.pCsPort |= flash.CsMask;
+
+    return rx[1];
+}
+
+int main(void) {
+    uint16_t value;
+
+    UART_StdioInit(USART_STD_BAUD_9600, USART_MODE_ONLY_TX, UART_STDIO_BUFFERED);
+
+    SPI_Inits();
+    SPI_DeviceInits();
+
+    IRQ_EN();
+
+    xprintf("SPI transaction queue\n");
+    xprintf("Flash status: %02X\n", Flash_status());
+
+    Display_config();
+    Xfer_queue(&flash_xfer, &flash, flash_tx, flash_rx, sizeof(flash_tx), Flash_done);
+
+    while (1) {
+        if (flash_ready) {
+            flash_ready = 0;
+            xprintf("Flash JEDEC ID: %02X %02X %02X\n", flash_rx[1], flash_rx[2], flash_rx[3]);
+        }
+
+        if (adc_state == ADC_IDLE) {
+            adc_state = ADC_BUSY;
+            Xfer_queue(&adc_xfer, &adc, adc_tx, adc_rx, sizeof(adc_tx), Adc_done);
+        }
+        else if ((adc_state == ADC_READY) && (display_busy == 0)) {
+            // 10-bit result in the last two bytes
+            value = ((uint16_t)(adc_rx[1] & 0x03) << 8) | adc_rx[2];
+            Display_write(value);
+            xprintf("ADC%u: %u\n", ADC_CHANNEL, value);
+
+            Delay_ms(200);
+            adc_state = ADC_IDLE;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 HumbertoOntiveros
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Happy coding!
+ */
\ No newline at end of file